@@ -0,0 +1,304 @@
+#include "IniFile.h"
+#include "FrozenIniFile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::atomic<size_t> allocations{0};
+
+    struct options
+    {
+        size_t _sections = 20000;
+        double _duplicates = 0.2;
+        size_t _keys = 10;
+        size_t _valueSize = 16;
+        size_t _lookups = 1000000;
+    };
+
+    struct result
+    {
+        double _seconds;
+        size_t _allocations;
+    };
+
+    template<typename F>
+    result measure(F&& body)
+    {
+        size_t before = allocations.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+
+        body();
+
+        std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+        return {time.count(), allocations.load(std::memory_order_relaxed) - before};
+    }
+
+    void report(const std::string& name, const result& item, size_t operations, size_t bytes = 0)
+    {
+        std::cout << std::left << std::setw(34) << name << std::right << std::fixed;
+
+        if (bytes != 0)
+        {
+            std::cout << std::setw(10) << std::setprecision(1) << bytes / item._seconds / (1024 * 1024) << " MB/s";
+        }
+        else
+        {
+            std::cout << std::setw(10) << std::setprecision(1) << item._seconds * 1e9 / operations << " ns/op";
+        }
+
+        std::cout << std::setw(12) << std::setprecision(2) << static_cast<double>(item._allocations) / operations
+                  << " allocs/op" << '\n';
+    }
+
+    // Duplicated sections reuse earlier names, every key gets an int, a double, a bool and a string value
+    size_t generate(const std::string& path, const options& opts)
+    {
+        std::mt19937 random(42);
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        size_t uniqueCount = 0;
+
+        for (size_t i = 0; i < opts._sections; ++i)
+        {
+            bool duplicate = uniqueCount != 0 && std::uniform_real_distribution<double>(0, 1)(random) < opts._duplicates;
+            size_t name = duplicate ? random() % uniqueCount : uniqueCount++;
+
+            file << "[section" << name << "]\n";
+
+            for (size_t k = 0; k < opts._keys; ++k)
+            {
+                switch (k % 4)
+                {
+                    case 0:
+                        file << "int" << k << " = " << static_cast<int>(random() % 100000) << '\n';
+                        break;
+                    case 1:
+                        file << "double" << k << " = " << (random() % 100000) / 7.0 << '\n';
+                        break;
+                    case 2:
+                        file << "bool" << k << " = " << (random() % 2 ? "true" : "false") << '\n';
+                        break;
+                    default:
+                        file << "string" << k << " = " << std::string(opts._valueSize, char('a' + random() % 26)) << '\n';
+                        break;
+                }
+            }
+
+            file << '\n';
+        }
+
+        return uniqueCount;
+    }
+
+    template<typename File>
+    void lookups(const std::string& backend, const File& file, const options& opts, size_t uniqueCount)
+    {
+        std::mt19937 random(7);
+        std::vector<std::string> names;
+
+        for (size_t i = 0; i < 1024; ++i)
+        {
+            names.push_back( "section" + std::to_string(random() % uniqueCount) );
+        }
+
+        volatile long long sink = 0;
+
+        report(backend + " read<int>", measure([&](){
+            for (size_t i = 0; i < opts._lookups; ++i)
+            {
+                sink = sink + file.template read<int>(names[i & 1023], "int0");
+            }
+        }), opts._lookups);
+
+        report(backend + " read<double>", measure([&](){
+            for (size_t i = 0; i < opts._lookups; ++i)
+            {
+                sink = sink + static_cast<long long>( file.template read<double>(names[i & 1023], "double1") );
+            }
+        }), opts._lookups);
+
+        report(backend + " read<bool>", measure([&](){
+            for (size_t i = 0; i < opts._lookups; ++i)
+            {
+                sink = sink + file.template read<bool>(names[i & 1023], "bool2");
+            }
+        }), opts._lookups);
+
+        report(backend + " read<std::string>", measure([&](){
+            for (size_t i = 0; i < opts._lookups; ++i)
+            {
+                sink = sink + static_cast<long long>( file.template read<std::string>(names[i & 1023], "string3").size() );
+            }
+        }), opts._lookups);
+
+        report(backend + " read missing key", measure([&](){
+            for (size_t i = 0; i < opts._lookups; ++i)
+            {
+                sink = sink + file.template read<int>(names[i & 1023], "missing", 1);
+            }
+        }), opts._lookups);
+
+        report(backend + " sectionRange", measure([&](){
+            for (size_t i = 0; i < opts._lookups / 10; ++i)
+            {
+                sink = sink + static_cast<long long>( file.sectionRange(names[i & 1023]).size() );
+            }
+        }), opts._lookups / 10);
+    }
+
+    options parseOptions(int argc, char** argv)
+    {
+        options opts;
+
+        for (int i = 1; i + 1 < argc; i += 2)
+        {
+            std::string name = argv[i];
+            std::string value = argv[i + 1];
+
+            if (name == "--sections")
+            {
+                opts._sections = std::stoul(value);
+            }
+            else if (name == "--duplicates")
+            {
+                opts._duplicates = std::stod(value);
+            }
+            else if (name == "--keys")
+            {
+                opts._keys = std::stoul(value);
+            }
+            else if (name == "--value-size")
+            {
+                opts._valueSize = std::stoul(value);
+            }
+            else if (name == "--lookups")
+            {
+                opts._lookups = std::stoul(value);
+            }
+            else
+            {
+                throw std::runtime_error("unknown option: " + name);
+            }
+        }
+
+        if (opts._sections == 0 || opts._keys < 4)
+        {
+            throw std::runtime_error("need at least one section and four keys per section");
+        }
+
+        return opts;
+    }
+}
+
+// The default memory resource allocates with an explicit alignment, so both forms are counted
+void* operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    // aligned_alloc wants a multiple of the alignment
+    auto align = static_cast<size_t>(alignment);
+
+    if (void* memory = std::aligned_alloc(align, (std::max<size_t>(size, 1) + align - 1) / align * align))
+    {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+// Both news allocate from the malloc family, so every delete goes through this one free
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    ::operator delete(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    ::operator delete(memory);
+}
+
+void operator delete(void* memory, size_t, std::align_val_t) noexcept
+{
+    ::operator delete(memory);
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        options opts = parseOptions(argc, argv);
+
+        auto dir = std::filesystem::temp_directory_path();
+        std::string path = (dir / "IniFileBenchmark.ini").string();
+        std::string imagePath = (dir / "IniFileBenchmark.img").string();
+
+        size_t uniqueCount = generate(path, opts);
+        size_t bytes = std::filesystem::file_size(path);
+
+        std::cout << opts._sections << " sections (" << uniqueCount << " unique), " << opts._keys << " keys each, "
+                  << bytes / 1024 << " KiB\n\n";
+
+        IniFile file(path);
+
+        report("load Buffered", measure([&](){ file.load(LoadMode::Buffered); }), 1, bytes);
+        report("load Mapped", measure([&](){ file.load(LoadMode::Mapped); }), 1, bytes);
+        report("load Mapped, all cores", measure([&](){ file.load(LoadMode::Mapped, 0); }), 1, bytes);
+        report("reload unchanged", measure([&](){ file.reload(); }), 1);
+
+        FrozenIniFile frozen = file.freeze();
+        report("freeze", measure([&](){ frozen = file.freeze(); }), 1, bytes);
+
+        frozen.saveImage(imagePath);
+        report("loadImage", measure([&](){ frozen = FrozenIniFile::loadImage(imagePath); }), 1, bytes);
+
+        std::cout << '\n';
+        lookups("IniFile", file, opts, uniqueCount);
+
+        file.enableCache();
+        lookups("IniFile cached", file, opts, uniqueCount);
+        file.enableCache(false);
+
+        lookups("FrozenIniFile", frozen, opts, uniqueCount);
+
+        std::cout << '\n';
+        report("save", measure([&](){ file.save(); }), 1, bytes);
+
+        std::filesystem::remove(path);
+        std::filesystem::remove(imagePath);
+    }
+    catch (const std::exception& error)
+    {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
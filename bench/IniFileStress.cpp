@@ -0,0 +1,569 @@
+#include "IniFile.h"
+#include "IniParser.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Every allocation carries its size in front, so the live and peak heap use can be followed
+    constexpr size_t header = alignof(std::max_align_t);
+
+    std::atomic<size_t> liveBytes{0};
+    std::atomic<size_t> peakBytes{0};
+
+    struct options
+    {
+        size_t _size = 16 << 20;
+        size_t _fuzzCases = 200;
+        size_t _fuzzSize = 64 << 10;
+        unsigned _seed = 1;
+        double _maxNsPerByte = 100;
+        double _maxPeakRatio = 64;
+    };
+
+    struct result
+    {
+        double _seconds;
+        size_t _peak;
+        std::string _error;
+    };
+
+    template<typename F>
+    result measure(F&& body)
+    {
+        peakBytes.store(liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        size_t before = liveBytes.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+        std::string error;
+
+        try
+        {
+            body();
+        }
+        catch (const std::exception& exception)
+        {
+            error = exception.what();
+        }
+
+        std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+        return {time.count(), peakBytes.load(std::memory_order_relaxed) - before, error};
+    }
+
+    std::string repeat(std::string_view text, size_t size)
+    {
+        std::string out;
+        out.reserve(size + text.size());
+
+        while (out.size() < size)
+        {
+            out += text;
+        }
+
+        return out;
+    }
+
+    std::string numbered(std::string_view before, std::string_view after, size_t size)
+    {
+        std::string out;
+        out.reserve(size + 64);
+
+        for (size_t i = 0; out.size() < size; ++i)
+        {
+            out.append(before).append( std::to_string(i) ).append(after);
+        }
+
+        return out;
+    }
+
+    // Words of the 64-bit MurmurHash2 that std::hash uses in libstdc++. Flipping the top bit of one
+    // mixed word and of the next one leaves the state as it was, whatever the seed. So blocks of two
+    // words, each taken as is or flipped, give 2^n names of 16n chars with one hash.
+    constexpr std::uint64_t murmurMul = 0xc6a4a7935bd1e995ULL;
+
+    std::uint64_t inverse(std::uint64_t odd)
+    {
+        std::uint64_t result = odd;
+
+        for (int i = 0; i < 5; ++i)
+        {
+            result *= 2 - odd * result;
+        }
+
+        return result;
+    }
+
+    std::uint64_t shiftMix(std::uint64_t value)
+    {
+        return value ^ (value >> 47);
+    }
+
+    // Any byte but blanks, controls and the ones the parser splits lines at, high bytes included
+    bool nameByte(unsigned char c)
+    {
+        return c > ' ' && c != 0x7f && std::string_view("[]=;#").find( static_cast<char>(c) ) == std::string_view::npos;
+    }
+
+    bool nameWord(std::uint64_t word)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            if ( !nameByte( static_cast<unsigned char>(word >> (8 * i)) ) )
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    std::string bytes(std::uint64_t word)
+    {
+        std::string out(8, ' ');
+        std::memcpy(out.data(), &word, 8);
+
+        return out;
+    }
+
+    // Names of equal hash when std::hash is MurmurHash2, enough to fill size bytes
+    std::vector<std::string> collidingNames(size_t size, std::mt19937& random)
+    {
+        std::uint64_t mulInverse = inverse(murmurMul);
+        std::vector<std::pair<std::string, std::string>> words;
+        size_t blocks = 1;
+
+        while ( (size_t(1) << blocks) * 16 * blocks < size )
+        {
+            ++blocks;
+        }
+
+        size_t count = std::min(size / (16 * blocks) + 1, size_t(1) << blocks);
+
+        while (words.size() < 2 * blocks)
+        {
+            std::uint64_t word = (std::uint64_t(random()) << 32) | random();
+            std::uint64_t mixed = shiftMix(word * murmurMul) * murmurMul;
+            std::uint64_t flipped = shiftMix( (mixed ^ (std::uint64_t(1) << 63)) * mulInverse ) * mulInverse;
+
+            if ( nameWord(word) && nameWord(flipped) )
+            {
+                words.emplace_back(bytes(word), bytes(flipped));
+            }
+        }
+
+        std::vector<std::string> names;
+        names.reserve(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            std::string name;
+
+            for (size_t block = 0; block < blocks; ++block)
+            {
+                bool flip = (i >> block) & 1;
+                name += flip ? words[2 * block].second : words[2 * block].first;
+                name += flip ? words[2 * block + 1].second : words[2 * block + 1].first;
+            }
+
+            names.push_back( std::move(name) );
+        }
+
+        return names;
+    }
+
+    std::string lines(const std::vector<std::string>& names, std::string_view before, std::string_view after)
+    {
+        std::string out;
+
+        for (const auto& name : names)
+        {
+            out.append(before).append(name).append(after);
+        }
+
+        return out;
+    }
+
+    // Inputs aimed at the parser's per-line scans, the section and key indexes and the line splitter
+    std::vector<std::pair<std::string, std::string>> adversarial(size_t size, std::mt19937& random)
+    {
+        std::string prefix(256, 'p');
+        std::vector<std::string> names = collidingNames(size, random);
+
+        if (std::hash<std::string_view>{}(names[0]) != std::hash<std::string_view>{}(names[1]))
+        {
+            std::cout << "std::hash is not MurmurHash2 here, the colliding names have different hashes\n\n";
+        }
+
+        return {
+            {"one long value", "[s]\nk=" + std::string(size, 'v') + '\n'},
+            {"one long comment", "; " + std::string(size, 'c') + '\n'},
+            {"one long section name", '[' + std::string(size, 'n') + "]\n"},
+            {"one long key", "[s]\n" + std::string(size, 'k') + "=1\n"},
+            {"value of '=' and '['", "[s]\nk=" + repeat("=[]", size) + '\n'},
+            {"value of spaces", "[s]\nk=" + std::string(size, ' ') + "v\n"},
+            {"value without final newline", "[s]\nk=" + std::string(size, 'v')},
+            {"duplicate empty sections", repeat("[s]\n", size)},
+            {"duplicate sections with a key", repeat("[s]\nk=1\n", size)},
+            {"keys of one section", "[s]\n" + numbered("k", "=1\n", size)},
+            {"long common name prefix", numbered('[' + prefix, "]\nk=1\n", size)},
+            {"long common key prefix", "[s]\n" + numbered(prefix, "=1\n", size)},
+            {"blank lines", std::string(size, '\n')},
+            {"CRLF lines", "[s]\r\n" + numbered("k", "=1\r\n", size)},
+            {"comments after values", "[s]\n" + numbered("k", " = 1 ; note ; note\n", size)},
+            {"sections of one hash", lines(names, "[", "]\nk=1\n")},
+            {"keys of one hash", "[s]\n" + lines(names, "", "=1\n")},
+        };
+    }
+
+    std::string fuzzName(std::mt19937& random, std::string_view alphabet)
+    {
+        std::string name( 1 + random() % 12, ' ' );
+
+        for (char& c : name)
+        {
+            c = alphabet[random() % alphabet.size()];
+        }
+
+        return name;
+    }
+
+    // Well-formed files of sections, key lines, comments and blank lines, spaced with spaces since the
+    // parser trims nothing else. A quarter of them get a few lines corrupted, the rest must load
+    std::string fuzzInput(std::mt19937& random, size_t size, bool& corrupted)
+    {
+        static constexpr std::string_view nameBytes = "abcxyzk019._-";
+        static constexpr std::string_view valueBytes = "abk01.-_ =[]#";
+        static constexpr std::string_view blanks[] = {"", " ", "  ", "   "};
+        static constexpr std::string_view corruption = "[]=;\n\r\t#";
+
+        std::string out;
+        out.reserve(size + 64);
+
+        size_t key = 0;
+        auto blank = [&](){ return blanks[random() % std::size(blanks)]; };
+
+        out.append("[").append( fuzzName(random, nameBytes) ) += "]\n";
+
+        while (out.size() < size)
+        {
+            switch (random() % 16)
+            {
+                case 0:
+                    out.append(blank()).append("[").append( fuzzName(random, nameBytes) ).append("]");
+                    out.append(blank()) += '\n';
+                    key = 0;
+                    break;
+
+                case 1:
+                    out.append(blank()).append("; ").append( fuzzName(random, valueBytes) ) += '\n';
+                    break;
+
+                case 2:
+                    out.append(blank()) += random() % 2 ? "\n" : "\r\n";
+                    break;
+
+                default:
+                    // Numbered after a byte no name has, so keys never repeat in a section. Values start with
+                    // a name byte and never trim to nothing
+                    out.append(blank()).append( fuzzName(random, nameBytes) ).append("@").append( std::to_string(key++) );
+                    out.append(blank()).append("=").append(blank());
+                    out.append( fuzzName(random, nameBytes) ).append( fuzzName(random, valueBytes) );
+
+                    if (random() % 4 == 0)
+                    {
+                        out.append(" ; ").append( fuzzName(random, valueBytes) );
+                    }
+
+                    out += random() % 8 == 0 ? "\r\n" : "\n";
+                    break;
+            }
+        }
+
+        corrupted = random() % 4 == 0;
+
+        if (corrupted)
+        {
+            for (unsigned count = 1 + random() % 3; count > 0; --count)
+            {
+                size_t pos = random() % out.size();
+                size_t lineStart = pos == 0 ? 0 : out.rfind('\n', pos - 1) + 1;
+                size_t lineEnd = std::min(out.find('\n', pos), out.size() - 1) + 1;
+
+                switch (random() % 5)
+                {
+                    case 0:
+                        out[pos] = corruption[random() % corruption.size()];
+                        break;
+
+                    case 1:
+                        out.erase(pos, 1);
+                        break;
+
+                    case 2:
+                        out.insert(lineStart, "=" + fuzzName(random, nameBytes) + '\n');
+                        break;
+
+                    case 3:
+                        out.insert(lineStart, fuzzName(random, nameBytes) + '\n');
+                        break;
+
+                    default:
+                        // A key line twice is a duplicate key
+                        out.insert( lineEnd, out.substr(lineStart, lineEnd - lineStart) );
+                        break;
+                }
+            }
+        }
+
+        return out;
+    }
+
+    void write(const std::string& path, const std::string& text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write( text.data(), static_cast<std::streamsize>( text.size() ) );
+    }
+
+    double nsPerByte(const result& item, size_t bytes)
+    {
+        return item._seconds * 1e9 / static_cast<double>( std::max<size_t>(bytes, 1) );
+    }
+
+    double peakRatio(const result& item, size_t bytes)
+    {
+        return static_cast<double>(item._peak) / static_cast<double>( std::max<size_t>(bytes, 1) );
+    }
+
+    void report(const std::string& name, size_t bytes, const result& load, const result& stream, const options& opts)
+    {
+        std::cout << std::left << std::setw(32) << name << std::right << std::fixed
+                  << std::setw(10) << bytes / 1024 << " KiB"
+                  << std::setw(10) << std::setprecision(1) << load._seconds * 1e3 << " ms"
+                  << std::setw(8) << std::setprecision(2) << nsPerByte(load, bytes) << " ns/B"
+                  << std::setw(10) << std::setprecision(1) << static_cast<double>(load._peak) / (1 << 20) << " MiB peak"
+                  << std::setw(8) << std::setprecision(2) << nsPerByte(stream, bytes) << " ns/B stream";
+
+        if (std::max( nsPerByte(load, bytes), nsPerByte(stream, bytes) ) > opts._maxNsPerByte)
+        {
+            std::cout << "  SLOW";
+        }
+
+        if (std::max( peakRatio(load, bytes), peakRatio(stream, bytes) ) > opts._maxPeakRatio)
+        {
+            std::cout << "  HEAVY";
+        }
+
+        if ( !load._error.empty() )
+        {
+            std::cout << "  (" << load._error.substr(0, 48) << ')';
+        }
+
+        std::cout << '\n';
+    }
+
+    options parseOptions(int argc, char** argv)
+    {
+        options opts;
+
+        for (int i = 1; i + 1 < argc; i += 2)
+        {
+            std::string name = argv[i];
+            std::string value = argv[i + 1];
+
+            if (name == "--size-mib")
+            {
+                opts._size = std::stoul(value) << 20;
+            }
+            else if (name == "--fuzz-cases")
+            {
+                opts._fuzzCases = std::stoul(value);
+            }
+            else if (name == "--fuzz-size")
+            {
+                opts._fuzzSize = std::stoul(value);
+            }
+            else if (name == "--seed")
+            {
+                opts._seed = static_cast<unsigned>( std::stoul(value) );
+            }
+            else if (name == "--max-ns-per-byte")
+            {
+                opts._maxNsPerByte = std::stod(value);
+            }
+            else if (name == "--max-peak-ratio")
+            {
+                opts._maxPeakRatio = std::stod(value);
+            }
+            else
+            {
+                throw std::runtime_error("unknown option: " + name);
+            }
+        }
+
+        if (opts._size == 0)
+        {
+            throw std::runtime_error("need a size of at least one MiB");
+        }
+
+        return opts;
+    }
+
+    void* allocate(size_t size, size_t alignment)
+    {
+        // aligned_alloc wants a multiple of the alignment
+        size_t total = (size + alignment + alignment - 1) / alignment * alignment;
+
+        if (auto* memory = static_cast<char*>( std::aligned_alloc(alignment, total) ))
+        {
+            *reinterpret_cast<size_t*>(memory) = size;
+
+            size_t live = liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+            size_t peak = peakBytes.load(std::memory_order_relaxed);
+
+            while (live > peak && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+            {}
+
+            return memory + alignment;
+        }
+
+        throw std::bad_alloc();
+    }
+
+    void release(void* memory, size_t alignment) noexcept
+    {
+        if (memory == nullptr)
+        {
+            return;
+        }
+
+        auto* block = static_cast<char*>(memory) - alignment;
+        liveBytes.fetch_sub(*reinterpret_cast<size_t*>(block), std::memory_order_relaxed);
+
+        std::free(block);
+    }
+}
+
+// The default memory resource allocates with an explicit alignment, so both forms are counted
+void* operator new(size_t size)
+{
+    return allocate(size, header);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    return allocate( size, std::max(header, static_cast<size_t>(alignment)) );
+}
+
+void operator delete(void* memory) noexcept
+{
+    release(memory, header);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    release(memory, header);
+}
+
+void operator delete(void* memory, std::align_val_t alignment) noexcept
+{
+    release( memory, std::max(header, static_cast<size_t>(alignment)) );
+}
+
+void operator delete(void* memory, size_t, std::align_val_t alignment) noexcept
+{
+    release( memory, std::max(header, static_cast<size_t>(alignment)) );
+}
+
+// Loads every input with IniFile and streams it through IniParser, a bad input may throw but must stay
+// linear. Exits with 1 when any input costs more than --max-ns-per-byte or its peak heap is more than
+// --max-peak-ratio times its size, or when a fuzz input that was not corrupted is rejected
+int main(int argc, char** argv)
+{
+    try
+    {
+        options opts = parseOptions(argc, argv);
+        std::string path = (std::filesystem::temp_directory_path() / "IniFileStress.ini").string();
+        bool failed = false;
+
+        auto run = [&](const std::string& name, const std::string& text, bool print) {
+            write(path, text);
+
+            result load = measure([&](){
+                IniFile file(path);
+                file.load();
+            });
+
+            result stream = measure([&](){
+                IniHandler handler;
+                IniParser(path).parse(handler);
+            });
+
+            double cost = std::max( nsPerByte(load, text.size()), nsPerByte(stream, text.size()) );
+            double ratio = std::max( peakRatio(load, text.size()), peakRatio(stream, text.size()) );
+            bool over = cost > opts._maxNsPerByte || ratio > opts._maxPeakRatio;
+            failed = failed || over;
+
+            if (print || over)
+            {
+                report(name, text.size(), load, stream, opts);
+            }
+
+            return std::make_pair(cost, !load._error.empty());
+        };
+
+        std::mt19937 random(opts._seed);
+
+        for (const auto& [name, text] : adversarial(opts._size, random))
+        {
+            run(name, text, true);
+        }
+
+        double worst = 0;
+        size_t errors = 0;
+        size_t wellFormedErrors = 0;
+
+        for (size_t i = 0; i < opts._fuzzCases; ++i)
+        {
+            bool corrupted = false;
+            std::string text = fuzzInput(random, opts._fuzzSize, corrupted);
+            auto [cost, rejected] = run("fuzz #" + std::to_string(i), text, false);
+
+            worst = std::max(worst, cost);
+            errors += rejected;
+
+            if (rejected && !corrupted)
+            {
+                std::cout << "fuzz #" << i << " is well-formed but was rejected\n";
+                ++wellFormedErrors;
+            }
+        }
+
+        failed = failed || wellFormedErrors > 0;
+
+        std::cout << '\n' << opts._fuzzCases << " fuzz inputs of " << opts._fuzzSize / 1024 << " KiB, seed " << opts._seed
+                  << ": " << opts._fuzzCases - errors << " accepted, " << errors << " rejected, worst " << std::fixed
+                  << std::setprecision(2) << worst << " ns/B\n";
+
+        std::filesystem::remove(path);
+
+        return failed ? 1 : 0;
+    }
+    catch (const std::exception& error)
+    {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,27 @@
+#include "ConcurrentIniFile.h"
+
+ConcurrentIniFile::ConcurrentIniFile(std::string path, LoadMode mode) : _path( std::move(path) ), _mode(mode)
+{
+    reload();
+}
+
+std::shared_ptr<const IniFile> ConcurrentIniFile::snapshot() const
+{
+    return std::atomic_load(&_snapshot);
+}
+
+void ConcurrentIniFile::reload()
+{
+    std::lock_guard<std::mutex> lock(_reloadMutex);
+
+    auto file = std::make_shared<IniFile>(_path);
+    file->load(_mode);
+
+    std::atomic_store(&_snapshot, std::shared_ptr<const IniFile>( std::move(file) ));
+}
+
+void ConcurrentIniFile::publish(IniFile file)
+{
+    std::lock_guard<std::mutex> lock(_reloadMutex);
+    std::atomic_store(&_snapshot, std::make_shared<const IniFile>( std::move(file) ));
+}
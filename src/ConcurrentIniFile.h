@@ -0,0 +1,54 @@
+#ifndef CONCURRENTINIFILE_H
+#define CONCURRENTINIFILE_H
+
+#include "IniFile.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+
+// Readers work on an immutable IniFile snapshot taken from an atomic pointer, a reload parses
+// the new file on the side and publishes it with one pointer swap. Old snapshots stay valid
+// for as long as a reader holds them.
+class ConcurrentIniFile
+{
+public:
+    explicit ConcurrentIniFile(std::string path, LoadMode mode = LoadMode::Buffered);
+
+    std::shared_ptr<const IniFile> snapshot() const;
+
+    void reload();
+    void publish(IniFile file);
+
+    template<typename T>
+    T read(const IniSection& section, std::string_view key, T defaultValue = T{}) const;
+
+    template<typename T, typename S, std::enable_if_t<std::is_convertible_v<const S&, std::string_view>, int> = 0>
+    T read(const S& section, std::string_view key, T defaultValue = T{}) const;
+
+private:
+    std::string _path;
+    LoadMode _mode;
+
+    std::shared_ptr<const IniFile> _snapshot;
+    std::mutex _reloadMutex;
+};
+
+
+template<typename T>
+T ConcurrentIniFile::read(const IniSection& section, std::string_view key, T defaultValue) const
+{
+    return snapshot()->read<T>(section, key, std::move(defaultValue));
+}
+
+template<typename T, typename S, std::enable_if_t<std::is_convertible_v<const S&, std::string_view>, int>>
+T ConcurrentIniFile::read(const S& section, std::string_view key, T defaultValue) const
+{
+    return snapshot()->read<T>(std::string_view(section), key, std::move(defaultValue));
+}
+
+
+#endif //CONCURRENTINIFILE_H
@@ -0,0 +1,510 @@
+#include "FrozenIniFile.h"
+#include "IniFile.h"
+
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+namespace
+{
+    size_t words(size_t bytes)
+    {
+        return (bytes + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+    }
+
+    std::uint32_t slotCount(size_t items)
+    {
+        std::uint32_t count = 1;
+
+        while (count < items * 2)
+        {
+            count <<= 1;
+        }
+
+        return count;
+    }
+
+    std::uint32_t narrow(size_t value)
+    {
+        if (value >= UINT32_MAX)
+        {
+            throw std::runtime_error("IniFile is too large to freeze");
+        }
+
+        return static_cast<std::uint32_t>(value);
+    }
+}
+
+FrozenIniFile::FrozenIniFile(const IniFile& file)
+{
+    std::vector<section> sections;
+    std::vector<group> groups;
+    std::vector<std::uint32_t> order;
+    std::vector<key> keys;
+    std::string textArea;
+
+    std::unordered_map<std::string_view, text, parser::seededHasher> names;
+
+    auto addName = [&](std::string_view name) {
+        auto it = names.find(name);
+
+        if (it != names.end())
+        {
+            return it->second;
+        }
+
+        text item{narrow( textArea.size() ), narrow( name.size() )};
+        textArea.append( name.begin(), name.end() );
+        names.emplace(name, item);
+
+        return item;
+    };
+
+    sections.reserve( file._data.size() );
+
+    for (const auto& entry : file._data)
+    {
+        const auto& keyValues = entry._keys;
+
+        auto sectionNum = narrow( sections.size() );
+        sections.push_back({addName(entry._element._name), narrow(entry._index), narrow(entry._element._lineNum),
+                            narrow( keys.size() ), narrow( keyValues.size() )});
+
+        for (const auto& pair : keyValues)
+        {
+            text name = addName(pair.first._name);
+            text value{narrow( textArea.size() ), narrow( pair.second.size() )};
+            textArea.append( pair.second.begin(), pair.second.end() );
+
+            keys.push_back({name, value, sectionNum, narrow(pair.first._lineNum)});
+        }
+
+        if (entry._index != 0)
+        {
+            continue;
+        }
+
+        const auto& positions = file._sectionIndex.find(entry._element)->second;
+        groups.push_back({sections.back()._name, narrow( order.size() ), narrow( positions.size() )});
+
+        for (size_t pos : positions)
+        {
+            order.push_back( narrow(pos) );
+        }
+    }
+
+    layout info{};
+    info._sectionCount = narrow( sections.size() );
+    info._groupCount = narrow( groups.size() );
+    info._keyCount = narrow( keys.size() );
+    info._groupSlotCount = slotCount( groups.size() );
+    info._keySlotCount = slotCount( keys.size() );
+    info._textSize = textArea.size();
+
+    size_t total = storageWords(info);
+
+    std::shared_ptr<std::uint64_t[]> storage(new std::uint64_t[total]());
+    char* out = reinterpret_cast<char*>( storage.get() );
+
+    auto write = [&out](const void* data, size_t bytes) {
+        if (bytes != 0)
+        {
+            std::memcpy(out, data, bytes);
+        }
+
+        out += words(bytes) * sizeof(std::uint64_t);
+    };
+
+    write(&info, sizeof(layout));
+    write(sections.data(), sizeof(section) * sections.size());
+    write(groups.data(), sizeof(group) * groups.size());
+    write(order.data(), sizeof(std::uint32_t) * order.size());
+    write(keys.data(), sizeof(key) * keys.size());
+
+    auto* groupSlots = reinterpret_cast<slot*>(out);
+    out += words( sizeof(slot) * info._groupSlotCount ) * sizeof(std::uint64_t);
+
+    auto* keySlots = reinterpret_cast<slot*>(out);
+    out += words( sizeof(slot) * info._keySlotCount ) * sizeof(std::uint64_t);
+
+    write(textArea.data(), textArea.size());
+
+    for (std::uint32_t i = 0; i < info._groupCount; ++i)
+    {
+        std::string_view name(textArea.data() + groups[i]._name._offset, groups[i]._name._size);
+        std::uint64_t hash = parser::hashName(name);
+        std::uint32_t pos = hash & (info._groupSlotCount - 1);
+
+        while (groupSlots[pos]._used != 0)
+        {
+            pos = (pos + 1) & (info._groupSlotCount - 1);
+        }
+
+        groupSlots[pos] = {hash, i, 1};
+    }
+
+    for (std::uint32_t i = 0; i < info._keyCount; ++i)
+    {
+        std::string_view name(textArea.data() + keys[i]._name._offset, keys[i]._name._size);
+        std::uint64_t hash = keyHash(keys[i]._section, parser::hashName(name));
+        std::uint32_t pos = hash & (info._keySlotCount - 1);
+
+        while (keySlots[pos]._used != 0)
+        {
+            pos = (pos + 1) & (info._keySlotCount - 1);
+        }
+
+        keySlots[pos] = {hash, i, 1};
+    }
+
+    _storage = storage;
+    bind( _storage.get() );
+}
+
+void FrozenIniFile::saveImage(const std::string& path) const
+{
+    size_t total = storageWords(*_layout);
+    imageHeader header{{'I', 'N', 'I', 'F', 'R', 'O', 'Z', 'N'}, imageVersion, 0x01020304, total,
+                       checksum(_storage.get(), total)};
+
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+
+    if ( !file.is_open() )
+    {
+        throw std::runtime_error("can't save FrozenIniFile image: " + path);
+    }
+
+    file.write( reinterpret_cast<const char*>(&header), sizeof(imageHeader) );
+    file.write( reinterpret_cast<const char*>( _storage.get() ), static_cast<std::streamsize>(total * sizeof(std::uint64_t)) );
+
+    if ( !file )
+    {
+        throw std::runtime_error("can't save FrozenIniFile image: " + path);
+    }
+}
+
+FrozenIniFile FrozenIniFile::loadImage(const std::string& path, LoadMode mode)
+{
+    auto buffer = IniBuffer::open(path, mode);
+    std::string_view data = buffer->view();
+
+    imageHeader header{};
+
+    if (data.size() < sizeof(imageHeader) + sizeof(layout))
+    {
+        throw std::runtime_error("not a FrozenIniFile image: " + path);
+    }
+
+    std::memcpy(&header, data.data(), sizeof(imageHeader));
+
+    if (std::memcmp(header._magic, "INIFROZN", sizeof(header._magic)) != 0 || header._byteOrder != 0x01020304)
+    {
+        throw std::runtime_error("not a FrozenIniFile image: " + path);
+    }
+
+    if (header._version != imageVersion)
+    {
+        throw std::runtime_error("unsupported FrozenIniFile image version: " + std::to_string(header._version));
+    }
+
+    // Mapped and heap buffers are at least 8 byte aligned and the header is a whole number of words
+    const auto* storage = reinterpret_cast<const std::uint64_t*>( data.data() + sizeof(imageHeader) );
+    size_t available = (data.size() - sizeof(imageHeader)) / sizeof(std::uint64_t);
+
+    // A text size past the file could wrap the word count around
+    const auto* info = reinterpret_cast<const layout*>(storage);
+
+    if (header._words != available || info->_textSize > available * sizeof(std::uint64_t) || storageWords(*info) != available ||
+        checksum(storage, available) != header._checksum)
+    {
+        throw std::runtime_error("corrupted FrozenIniFile image: " + path);
+    }
+
+    FrozenIniFile frozen;
+    frozen.bind(storage);
+
+    if ( !frozen.valid() )
+    {
+        throw std::runtime_error("corrupted FrozenIniFile image: " + path);
+    }
+
+    frozen._storage = std::shared_ptr<const std::uint64_t[]>(buffer, storage);
+
+    return frozen;
+}
+
+std::vector<IniSection> FrozenIniFile::operator[](const IniSection& name) const
+{
+    return sectionRange(name);
+}
+
+bool FrozenIniFile::sectionExists(const IniSection& section) const
+{
+    return findSection( section.getName(), section.getIndex() ) != npos;
+}
+
+bool FrozenIniFile::keyExists(const IniSection& section, std::string_view key) const
+{
+    return findKey(findSection( section.getName(), section.getIndex() ), key, parser::hashName(key)) != npos;
+}
+
+std::vector<IniSection> FrozenIniFile::sections() const
+{
+    std::vector<IniSection> sections;
+    sections.reserve(_layout->_sectionCount);
+
+    for (std::uint32_t i = 0; i < _layout->_sectionCount; ++i)
+    {
+        sections.push_back({view(_sections[i]._name), _sections[i]._index, _sections[i]._lineNum});
+    }
+
+    return sections;
+}
+
+std::vector<IniSection> FrozenIniFile::sectionRange(const IniSection& section) const
+{
+    std::vector<IniSection> sectionsArr;
+    std::uint32_t groupNum = findGroup( section.getName() );
+
+    if (groupNum == npos)
+    {
+        return sectionsArr;
+    }
+
+    const auto& item = _groups[groupNum];
+    sectionsArr.reserve(item._sectionCount);
+
+    for (std::uint32_t i = item._firstSection; i < item._firstSection + item._sectionCount; ++i)
+    {
+        sectionsArr.push_back({view(item._name), _sections[ _order[i] ]._index, _sections[ _order[i] ]._lineNum});
+    }
+
+    return sectionsArr;
+}
+
+size_t FrozenIniFile::sectionCount(const IniSection& section) const
+{
+    std::uint32_t groupNum = findGroup( section.getName() );
+
+    if (groupNum == npos)
+    {
+        return 0;
+    }
+
+    return _groups[groupNum]._sectionCount;
+}
+
+std::vector<std::string> FrozenIniFile::keys(const IniSection& section) const
+{
+    std::vector<std::string> keys;
+    std::uint32_t sectionNum = findSection( section.getName(), section.getIndex() );
+
+    if (sectionNum == npos)
+    {
+        return keys;
+    }
+
+    const auto& item = _sections[sectionNum];
+    keys.reserve(item._keyCount);
+
+    for (std::uint32_t i = item._firstKey; i < item._firstKey + item._keyCount; ++i)
+    {
+        keys.emplace_back( view(_keys[i]._name) );
+    }
+
+    return keys;
+}
+
+size_t FrozenIniFile::getKeyLineNum(const IniSection& section, std::string_view key) const
+{
+    std::uint32_t keyItem = findKey(findSection( section.getName(), section.getIndex() ), key, parser::hashName(key));
+
+    if (keyItem == npos)
+    {
+        return 0;
+    }
+
+    return _keys[keyItem]._lineNum;
+}
+
+void FrozenIniFile::bind(const std::uint64_t* storage)
+{
+    _layout = reinterpret_cast<const layout*>(storage);
+    storage += words( sizeof(layout) );
+
+    _sections = reinterpret_cast<const section*>(storage);
+    storage += words(sizeof(section) * _layout->_sectionCount);
+
+    _groups = reinterpret_cast<const group*>(storage);
+    storage += words(sizeof(group) * _layout->_groupCount);
+
+    _order = reinterpret_cast<const std::uint32_t*>(storage);
+    storage += words(sizeof(std::uint32_t) * _layout->_sectionCount);
+
+    _keys = reinterpret_cast<const key*>(storage);
+    storage += words(sizeof(key) * _layout->_keyCount);
+
+    _groupSlots = reinterpret_cast<const slot*>(storage);
+    storage += words(sizeof(slot) * _layout->_groupSlotCount);
+
+    _keySlots = reinterpret_cast<const slot*>(storage);
+    storage += words(sizeof(slot) * _layout->_keySlotCount);
+
+    _text = reinterpret_cast<const char*>(storage);
+}
+
+bool FrozenIniFile::valid() const
+{
+    const layout& info = *_layout;
+
+    auto powerOfTwo = [](std::uint32_t count) { return count != 0 && (count & (count - 1)) == 0; };
+    auto inText = [&info](text item) { return std::uint64_t(item._offset) + item._size <= info._textSize; };
+
+    // Probing stops at the first unused slot, so each table needs one
+    if ( !powerOfTwo(info._groupSlotCount) || !powerOfTwo(info._keySlotCount) ||
+         info._groupCount >= info._groupSlotCount || info._keyCount >= info._keySlotCount )
+    {
+        return false;
+    }
+
+    for (std::uint32_t i = 0; i < info._sectionCount; ++i)
+    {
+        const auto& item = _sections[i];
+
+        if ( !inText(item._name) || std::uint64_t(item._firstKey) + item._keyCount > info._keyCount || _order[i] >= info._sectionCount )
+        {
+            return false;
+        }
+    }
+
+    for (std::uint32_t i = 0; i < info._groupCount; ++i)
+    {
+        const auto& item = _groups[i];
+
+        if ( !inText(item._name) || std::uint64_t(item._firstSection) + item._sectionCount > info._sectionCount )
+        {
+            return false;
+        }
+    }
+
+    for (std::uint32_t i = 0; i < info._keyCount; ++i)
+    {
+        const auto& item = _keys[i];
+
+        if ( !inText(item._name) || !inText(item._value) || item._section >= info._sectionCount )
+        {
+            return false;
+        }
+    }
+
+    auto slotsValid = [](const slot* slots, std::uint32_t slotCount, std::uint32_t itemCount) {
+        std::uint32_t used = 0;
+
+        for (std::uint32_t pos = 0; pos < slotCount; ++pos)
+        {
+            if (slots[pos]._used == 0)
+            {
+                continue;
+            }
+
+            if (slots[pos]._item >= itemCount)
+            {
+                return false;
+            }
+
+            ++used;
+        }
+
+        return used == itemCount;
+    };
+
+    return slotsValid(_groupSlots, info._groupSlotCount, info._groupCount) &&
+           slotsValid(_keySlots, info._keySlotCount, info._keyCount);
+}
+
+size_t FrozenIniFile::storageWords(const layout& info)
+{
+    return words( sizeof(layout) ) + words( sizeof(section) * info._sectionCount ) +
+           words( sizeof(group) * info._groupCount ) + words( sizeof(std::uint32_t) * info._sectionCount ) +
+           words( sizeof(key) * info._keyCount ) + words( sizeof(slot) * info._groupSlotCount ) +
+           words( sizeof(slot) * info._keySlotCount ) + words(info._textSize);
+}
+
+std::uint64_t FrozenIniFile::checksum(const std::uint64_t* storage, size_t words)
+{
+    std::uint64_t hash = 14695981039346656037ull;
+
+    for (size_t i = 0; i < words; ++i)
+    {
+        hash = (hash ^ storage[i]) * 1099511628211ull;
+        hash ^= hash >> 29;
+    }
+
+    return hash;
+}
+
+std::string_view FrozenIniFile::view(text item) const
+{
+    return {_text + item._offset, item._size};
+}
+
+std::uint64_t FrozenIniFile::keyHash(std::uint32_t section, std::uint64_t nameHash)
+{
+    return nameHash ^ ( (static_cast<std::uint64_t>(section) + 1) * 0x9E3779B97F4A7C15ull );
+}
+
+std::uint32_t FrozenIniFile::findGroup(std::string_view name) const
+{
+    std::uint64_t hash = parser::hashName(name);
+
+    for (std::uint32_t pos = hash & (_layout->_groupSlotCount - 1); _groupSlots[pos]._used != 0;
+         pos = (pos + 1) & (_layout->_groupSlotCount - 1))
+    {
+        if (_groupSlots[pos]._hash == hash && view(_groups[ _groupSlots[pos]._item ]._name) == name)
+        {
+            return _groupSlots[pos]._item;
+        }
+    }
+
+    return npos;
+}
+
+std::uint32_t FrozenIniFile::findSection(std::string_view name, size_t index) const
+{
+    std::uint32_t groupNum = findGroup(name);
+
+    if (groupNum == npos || index >= _groups[groupNum]._sectionCount)
+    {
+        return npos;
+    }
+
+    return _order[_groups[groupNum]._firstSection + index];
+}
+
+std::uint32_t FrozenIniFile::findKey(std::uint32_t section, std::string_view name, std::uint64_t nameHash) const
+{
+    if (section == npos)
+    {
+        return npos;
+    }
+
+    std::uint64_t hash = keyHash(section, nameHash);
+
+    for (std::uint32_t pos = hash & (_layout->_keySlotCount - 1); _keySlots[pos]._used != 0;
+         pos = (pos + 1) & (_layout->_keySlotCount - 1))
+    {
+        const auto& item = _keys[ _keySlots[pos]._item ];
+
+        if (_keySlots[pos]._hash == hash && item._section == section && view(item._name) == name)
+        {
+            return _keySlots[pos]._item;
+        }
+    }
+
+    return npos;
+}
+
+std::string FrozenIniFile::addLineNum(std::uint32_t keyItem, const std::string& message) const
+{
+    return message + " in line: " + std::to_string(_keys[keyItem]._lineNum);
+}
@@ -0,0 +1,204 @@
+#ifndef FROZENINIFILE_H
+#define FROZENINIFILE_H
+
+#include "IniSection.h"
+#include "IniValue.h"
+#include "IniBuffer.h"
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+
+namespace parser
+{
+    constexpr std::uint64_t hashName(std::string_view name)
+    {
+        std::uint64_t hash = 14695981039346656037ull;
+
+        for (char item : name)
+        {
+            hash ^= static_cast<unsigned char>(item);
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+}
+
+
+class IniFile;
+
+// Read-only copy of an IniFile packed into one flat block: sections, keys and open addressing
+// tables are plain arrays and every name and value lives in a single text area
+class FrozenIniFile
+{
+    template<const auto&... Keys>
+    friend class IniRecord;
+
+private:
+    struct text
+    {
+        std::uint32_t _offset;
+        std::uint32_t _size;
+    };
+
+    struct section
+    {
+        text _name;
+        std::uint32_t _index;
+        std::uint32_t _lineNum;
+        std::uint32_t _firstKey;
+        std::uint32_t _keyCount;
+    };
+
+    struct group
+    {
+        text _name;
+        std::uint32_t _firstSection;
+        std::uint32_t _sectionCount;
+    };
+
+    struct key
+    {
+        text _name;
+        text _value;
+        std::uint32_t _section;
+        std::uint32_t _lineNum;
+    };
+
+    struct slot
+    {
+        std::uint64_t _hash;
+        std::uint32_t _item;
+        std::uint32_t _used;
+    };
+
+    struct layout
+    {
+        std::uint32_t _sectionCount;
+        std::uint32_t _groupCount;
+        std::uint32_t _keyCount;
+        std::uint32_t _groupSlotCount;
+        std::uint32_t _keySlotCount;
+        std::uint32_t _reserved;
+        std::uint64_t _textSize;
+    };
+
+    template<typename S>
+    using sectionName = std::enable_if_t<std::is_convertible_v<const S&, std::string_view>, int>;
+
+    // Prefix of a binary image, the checksum covers the storage words that follow it
+    struct imageHeader
+    {
+        char _magic[8];
+        std::uint32_t _version;
+        std::uint32_t _byteOrder;
+        std::uint64_t _words;
+        std::uint64_t _checksum;
+    };
+
+    static constexpr std::uint32_t npos = UINT32_MAX;
+    static constexpr std::uint32_t imageVersion = 1;
+
+public:
+    explicit FrozenIniFile(const IniFile& file);
+
+    // Writes the storage block as a binary image that loadImage() uses without parsing.
+    // Images are only readable on machines with the same byte order
+    void saveImage(const std::string& path) const;
+    static FrozenIniFile loadImage(const std::string& path, LoadMode mode = LoadMode::Mapped);
+
+    std::vector<IniSection> operator[](const IniSection& name) const;
+
+    template<typename T>
+    T read(const IniSection& section, std::string_view key, T defaultValue = T{}) const;
+
+    template<typename T, typename S, sectionName<S> = 0>
+    T read(const S& section, std::string_view key, T defaultValue = T{}) const;
+
+    bool sectionExists(const IniSection& section) const;
+    bool keyExists(const IniSection& section, std::string_view key) const;
+
+    std::vector<IniSection> sections() const;
+    std::vector<IniSection> sectionRange(const IniSection& section) const;
+    size_t sectionCount(const IniSection& section) const;
+
+    std::vector<std::string> keys(const IniSection& section) const;
+    size_t getKeyLineNum(const IniSection& section, std::string_view key) const;
+
+private:
+    std::shared_ptr<const std::uint64_t[]> _storage;
+
+    const layout* _layout = nullptr;
+    const section* _sections = nullptr;
+    const group* _groups = nullptr;
+    const std::uint32_t* _order = nullptr;
+    const key* _keys = nullptr;
+    const slot* _groupSlots = nullptr;
+    const slot* _keySlots = nullptr;
+    const char* _text = nullptr;
+
+    FrozenIniFile() = default;
+
+    void bind(const std::uint64_t* storage);
+
+    // Every count, index and text range of a bound image is inside its storage, lookups trust them
+    bool valid() const;
+
+    static size_t storageWords(const layout& info);
+    static std::uint64_t checksum(const std::uint64_t* storage, size_t words);
+
+    std::string_view view(text item) const;
+    static std::uint64_t keyHash(std::uint32_t section, std::uint64_t nameHash);
+
+    std::uint32_t findGroup(std::string_view name) const;
+    std::uint32_t findSection(std::string_view name, size_t index) const;
+    std::uint32_t findKey(std::uint32_t section, std::string_view name, std::uint64_t nameHash) const;
+
+    template<typename T>
+    T readValue(std::uint32_t section, std::string_view key, T defaultValue) const;
+
+    std::string addLineNum(std::uint32_t keyItem, const std::string& message) const;
+};
+
+
+template<typename T>
+T FrozenIniFile::read(const IniSection& section, std::string_view key, T defaultValue) const
+{
+    return readValue(findSection( section.getName(), section.getIndex() ), key, std::move(defaultValue));
+}
+
+template<typename T, typename S, FrozenIniFile::sectionName<S>>
+T FrozenIniFile::read(const S& section, std::string_view key, T defaultValue) const
+{
+    return readValue(findSection(section, 0), key, std::move(defaultValue));
+}
+
+template<typename T>
+T FrozenIniFile::readValue(std::uint32_t section, std::string_view key, T defaultValue) const
+{
+    std::uint32_t keyItem = findKey(section, key, parser::hashName(key));
+
+    if (keyItem == npos)
+    {
+        return defaultValue;
+    }
+
+    T value{};
+    const char* error = parser::parseValue(view( _keys[keyItem]._value ), value);
+
+    if (error != nullptr)
+    {
+        throw std::runtime_error( addLineNum(keyItem, error) );
+    }
+
+    return value;
+}
+
+
+#endif //FROZENINIFILE_H
@@ -0,0 +1,93 @@
+#include "IniArena.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+IniArena::IniArena(std::pmr::memory_resource* resource) : _resource(resource)
+{}
+
+IniArena::IniArena(const IniArena& other) : _resource(other._resource), _buffers(other._buffers), _blocks(other._blocks)
+{}
+
+IniArena& IniArena::operator=(const IniArena& other)
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+
+    _resource = other._resource;
+    _buffers = other._buffers;
+    _blocks = other._blocks;
+    _tail = nullptr;
+    _left = 0;
+    _nextBlockSize = minBlockSize;
+
+    return *this;
+}
+
+IniArena::IniArena(IniArena&& other) noexcept
+        : _resource(other._resource), _buffers( std::move(other._buffers) ), _blocks( std::move(other._blocks) ),
+          _tail( std::exchange(other._tail, nullptr) ), _left( std::exchange(other._left, 0) ),
+          _nextBlockSize( std::exchange(other._nextBlockSize, minBlockSize) )
+{}
+
+IniArena& IniArena::operator=(IniArena&& other) noexcept
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+
+    _resource = other._resource;
+    _buffers = std::move(other._buffers);
+    _blocks = std::move(other._blocks);
+    _tail = std::exchange(other._tail, nullptr);
+    _left = std::exchange(other._left, 0);
+    _nextBlockSize = std::exchange(other._nextBlockSize, minBlockSize);
+
+    return *this;
+}
+
+std::string_view IniArena::store(std::string_view text)
+{
+    if ( text.empty() )
+    {
+        return {};
+    }
+
+    if (text.size() > _left)
+    {
+        size_t blockSize = std::max(_nextBlockSize, text.size());
+        auto* memory = static_cast<char*>( _resource->allocate(blockSize, 1) );
+
+        std::shared_ptr<char[]> block(memory, [resource = _resource, blockSize](char* data){
+            resource->deallocate(data, blockSize, 1);
+        }, std::pmr::polymorphic_allocator<char>(_resource));
+
+        _blocks.push_back(block);
+        _tail = block.get();
+        _left = blockSize;
+        _nextBlockSize = std::min(_nextBlockSize * 2, maxBlockSize);
+    }
+
+    char* data = _tail;
+    std::memcpy(data, text.data(), text.size());
+
+    _tail += text.size();
+    _left -= text.size();
+
+    return {data, text.size()};
+}
+
+void IniArena::adopt(std::shared_ptr<const IniBuffer> buffer)
+{
+    _buffers.push_back( std::move(buffer) );
+}
+
+void IniArena::share(const IniArena& other)
+{
+    _buffers.insert(_buffers.end(), other._buffers.begin(), other._buffers.end());
+    _blocks.insert(_blocks.end(), other._blocks.begin(), other._blocks.end());
+}
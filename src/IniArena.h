@@ -0,0 +1,46 @@
+#ifndef INIARENA_H
+#define INIARENA_H
+
+#include "IniBuffer.h"
+
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+
+// Append-only text storage: stored bytes never move or change, so copies share every block
+// and only start a new one for their own writes
+class IniArena
+{
+public:
+    explicit IniArena(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    IniArena(const IniArena& other);
+    IniArena& operator=(const IniArena& other);
+
+    IniArena(IniArena&& other) noexcept;
+    IniArena& operator=(IniArena&& other) noexcept;
+
+    std::string_view store(std::string_view text);
+    void adopt(std::shared_ptr<const IniBuffer> buffer);
+
+    // Keeps everything stored in other alive for as long as this arena
+    void share(const IniArena& other);
+
+private:
+    static constexpr size_t minBlockSize = 4096;
+    static constexpr size_t maxBlockSize = 1 << 20;
+
+    std::pmr::memory_resource* _resource;
+
+    std::vector<std::shared_ptr<const IniBuffer>> _buffers;
+    std::vector<std::shared_ptr<const char[]>> _blocks;
+
+    char* _tail = nullptr;
+    size_t _left = 0;
+    size_t _nextBlockSize = minBlockSize;
+};
+
+
+#endif //INIARENA_H
@@ -0,0 +1,114 @@
+#include "IniBuffer.h"
+
+#include <cstddef>
+#include <fstream>
+#include <stdexcept>
+
+#if !defined(_WIN32)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+std::shared_ptr<const IniBuffer> IniBuffer::open(const std::string& path, LoadMode mode, std::pmr::memory_resource* resource)
+{
+    auto buffer = std::allocate_shared<IniBuffer>(std::pmr::polymorphic_allocator<IniBuffer>(resource), token{}, resource);
+
+    if (mode != LoadMode::Mapped || !buffer->map(path))
+    {
+        buffer->read(path);
+    }
+
+    return buffer;
+}
+
+IniBuffer::IniBuffer(token, std::pmr::memory_resource* resource) : _resource(resource)
+{}
+
+IniBuffer::~IniBuffer()
+{
+    if (_heap != nullptr)
+    {
+        _resource->deallocate(_heap, _size, alignof(std::max_align_t));
+    }
+
+#if !defined(_WIN32)
+    if (_mapped)
+    {
+        munmap(const_cast<char*>(_data), _size);
+    }
+#endif
+}
+
+std::string_view IniBuffer::view() const
+{
+    return {_data, _size};
+}
+
+bool IniBuffer::isMapped() const
+{
+    return _mapped;
+}
+
+bool IniBuffer::map(const std::string& path)
+{
+#if defined(_WIN32)
+    return false;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+
+    if (fd == -1)
+    {
+        return false;
+    }
+
+    struct stat info{};
+
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    void* address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (address == MAP_FAILED)
+    {
+        return false;
+    }
+
+    madvise(address, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+
+    _data = static_cast<const char*>(address);
+    _size = static_cast<size_t>(info.st_size);
+    _mapped = true;
+
+    return true;
+#endif
+}
+
+void IniBuffer::read(const std::string& path)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+
+    if ( !file.is_open() )
+    {
+        throw std::runtime_error("can't open IniFile: " + path);
+    }
+
+    auto size = static_cast<size_t>( file.tellg() );
+    file.seekg(0);
+
+    // FrozenIniFile images are read as words, so the text is aligned like any allocation
+    _heap = static_cast<char*>( _resource->allocate(size, alignof(std::max_align_t)) );
+    _size = size;
+
+    if ( !file.read(_heap, static_cast<std::streamsize>(size)) )
+    {
+        throw std::runtime_error("can't read IniFile: " + path);
+    }
+
+    _data = _heap;
+}
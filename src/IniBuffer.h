@@ -0,0 +1,53 @@
+#ifndef INIBUFFER_H
+#define INIBUFFER_H
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <memory_resource>
+
+
+enum class LoadMode
+{
+    Buffered,
+    Mapped
+};
+
+
+class IniBuffer
+{
+public:
+    // Mapped falls back to Buffered when the file can't be mapped. The buffer, its copy of the file
+    // and the shared_ptr control block are allocated from resource
+    static std::shared_ptr<const IniBuffer> open(const std::string& path, LoadMode mode = LoadMode::Buffered,
+                                                 std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    ~IniBuffer();
+
+    IniBuffer(const IniBuffer& other) = delete;
+    IniBuffer& operator=(const IniBuffer& other) = delete;
+
+    std::string_view view() const;
+    bool isMapped() const;
+
+private:
+    // Only open() can make one, allocate_shared needs a public constructor
+    struct token
+    {};
+
+public:
+    IniBuffer(token, std::pmr::memory_resource* resource);
+
+private:
+    bool map(const std::string& path);
+    void read(const std::string& path);
+
+    std::pmr::memory_resource* _resource;
+    const char* _data = nullptr;
+    size_t _size = 0;
+    bool _mapped = false;
+    char* _heap = nullptr;
+};
+
+
+#endif //INIBUFFER_H
@@ -0,0 +1,67 @@
+#include "IniBuilder.h"
+
+IniBuilder::IniBuilder(IniFile& file) : _file(file), _data(file._resource), _arena(file._resource)
+{}
+
+void IniBuilder::reserve(size_t sections, size_t keysPerSection)
+{
+    _data.reserve(_data.size() + sections);
+    _keysPerSection = keysPerSection;
+}
+
+IniBuilder& IniBuilder::section(std::string_view name)
+{
+    auto stored = _file._names ? std::string_view( *_file._names->intern(name) ) : _arena.store(name);
+
+    _data.push_back({{stored, 0}, 0, IniFile::keyMap(_file._resource), {}, true});
+    _data.back()._keys.reserve(_keysPerSection);
+
+    return *this;
+}
+
+void IniBuilder::commit()
+{
+    auto& data = _file._data;
+    data.reserve(data.size() + _data.size());
+
+    for (auto& entry : _data)
+    {
+        auto& positions = _file._sectionIndex[entry._element];
+
+        entry._index = positions.size();
+        positions.push_back( data.size() );
+        data.push_back( std::move(entry) );
+    }
+
+    _file._arena.share(_arena);
+    _file.dropNameIndex();
+
+    _data.clear();
+    _arena = IniArena(_file._resource);
+}
+
+size_t IniBuilder::sectionCount() const
+{
+    return _data.size();
+}
+
+void IniBuilder::addValue(std::string_view key, std::string_view value)
+{
+    if (key.empty() || value.empty())
+    {
+        throw std::runtime_error("empty key or value: " + std::string(key));
+    }
+
+    if ( _data.empty() )
+    {
+        throw std::runtime_error("key and value without section: " + std::string(key));
+    }
+
+    auto& keys = _data.back()._keys;
+    auto stored = _file._names ? std::string_view( *_file._names->intern(key) ) : _arena.store(key);
+
+    if ( !keys.insert({stored, _arena.store(value)}).second )
+    {
+        throw std::runtime_error("duplicate key: " + std::string(key));
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef INIBUILDER_H
+#define INIBUILDER_H
+
+#include "IniFile.h"
+
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+
+// Collects new sections and keys on the side and appends them to an IniFile in one commit().
+// Keys go straight into the current section, nothing is looked up per key. Without commit()
+// the file is left as it was
+class IniBuilder
+{
+public:
+    explicit IniBuilder(IniFile& file);
+
+    IniBuilder(const IniBuilder& other) = delete;
+    IniBuilder& operator=(const IniBuilder& other) = delete;
+
+    // Hints for the whole build, keysPerSection is reserved in every section started afterwards
+    void reserve(size_t sections, size_t keysPerSection);
+
+    // Starts a new section, a name already in the file or the builder adds a duplicate
+    IniBuilder& section(std::string_view name);
+
+    template<typename T>
+    IniBuilder& add(std::string_view key, const T& value);
+
+    // Appends everything built so far to the file, the builder can be used again afterwards
+    void commit();
+
+    size_t sectionCount() const;
+
+private:
+    IniFile& _file;
+
+    std::pmr::vector<IniFile::sectionEntry> _data;
+    IniArena _arena;
+    size_t _keysPerSection = 0;
+
+    void addValue(std::string_view key, std::string_view value);
+};
+
+
+template<typename T>
+IniBuilder& IniBuilder::add(std::string_view key, const T& value)
+{
+    if constexpr (std::is_same_v<T, bool>)
+    {
+        addValue(key, value ? alias::computerTruePrint : alias::computerFalsePrint);
+    }
+    else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+    {
+        addValue(key, value);
+    }
+    else if constexpr (std::is_same_v<T, char>)
+    {
+        addValue(key, std::string_view(&value, 1));
+    }
+    else
+    {
+        char buffer[parser::formatLength<T>];
+        addValue(key, std::string_view( buffer, parser::formatNumber(value, buffer) ));
+    }
+
+    return *this;
+}
+
+
+#endif //INIBUILDER_H
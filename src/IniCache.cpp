@@ -0,0 +1,109 @@
+#include "IniCache.h"
+
+#include <new>
+#include <utility>
+
+IniCache::slot::slot(const void* type) : _type(type)
+{}
+
+IniCache::table* IniCache::table::create(size_t size, std::pmr::memory_resource* resource)
+{
+    std::pmr::polymorphic_allocator<table> allocator(resource);
+
+    table* items = allocator.allocate(1);
+    allocator.construct(items, size, resource);
+
+    return items;
+}
+
+void IniCache::table::destroy(table* items)
+{
+    if (items == nullptr)
+    {
+        return;
+    }
+
+    std::pmr::polymorphic_allocator<table> allocator(items->_resource);
+
+    items->~table();
+    allocator.deallocate(items, 1);
+}
+
+IniCache::table::table(size_t size, std::pmr::memory_resource* resource)
+        : _resource(resource), _size(size),
+          _slots( std::pmr::polymorphic_allocator<std::atomic<slot*>>(resource).allocate(size) )
+{
+    for (size_t pos = 0; pos < _size; ++pos)
+    {
+        new (&_slots[pos]) std::atomic<slot*>(nullptr);
+    }
+}
+
+IniCache::table::~table()
+{
+    for (size_t pos = 0; pos < _size; ++pos)
+    {
+        slot* item = _slots[pos].load(std::memory_order_relaxed);
+
+        while (item != nullptr)
+        {
+            std::exchange(item, item->_next)->release(_resource);
+        }
+    }
+
+    std::pmr::polymorphic_allocator<std::atomic<slot*>>(_resource).deallocate(_slots, _size);
+}
+
+IniCache::~IniCache()
+{
+    clear();
+}
+
+IniCache::IniCache(const IniCache&)
+{}
+
+IniCache::IniCache(IniCache&& other) noexcept : _table( other._table.exchange(nullptr, std::memory_order_relaxed) )
+{}
+
+IniCache& IniCache::operator=(const IniCache& other)
+{
+    if (this != &other)
+    {
+        clear();
+    }
+
+    return *this;
+}
+
+IniCache& IniCache::operator=(IniCache&& other) noexcept
+{
+    if (this != &other)
+    {
+        clear();
+        _table.store(other._table.exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    return *this;
+}
+
+void IniCache::erase(size_t pos)
+{
+    table* items = _table.load(std::memory_order_relaxed);
+
+    if (items == nullptr || pos >= items->_size)
+    {
+        return;
+    }
+
+    slot* item = items->_slots[pos].exchange(nullptr, std::memory_order_relaxed);
+
+    while (item != nullptr)
+    {
+        std::exchange(item, item->_next)->release(items->_resource);
+    }
+}
+
+void IniCache::clear()
+{
+    table::destroy( _table.exchange(nullptr, std::memory_order_relaxed) );
+}
@@ -0,0 +1,164 @@
+#ifndef INICACHE_H
+#define INICACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+
+
+// Parsed values of read<T> for the keys of one section, by key position. The first read of a type
+// publishes its slot with a release store, later reads find it without a lock. Writers are exclusive,
+// so erase() and clear() may free slots. Tables and slots come from the resource of the first insert,
+// which readers share, so concurrent readers need a synchronized one. A copy starts empty.
+class IniCache
+{
+public:
+    IniCache() = default;
+    ~IniCache();
+
+    IniCache(const IniCache& other);
+    IniCache(IniCache&& other) noexcept;
+
+    IniCache& operator=(const IniCache& other);
+    IniCache& operator=(IniCache&& other) noexcept;
+
+    template<typename T>
+    bool find(size_t pos, T& value) const;
+
+    // Const because read<T> fills the cache, keyCount sizes the table on the first insert
+    template<typename T>
+    void insert(size_t pos, size_t keyCount, const T& value, std::pmr::memory_resource* resource) const;
+
+    void erase(size_t pos);
+    void clear();
+
+private:
+    struct slot
+    {
+        explicit slot(const void* type);
+        virtual ~slot() = default;
+
+        // Destroys the slot and gives its memory back to resource
+        virtual void release(std::pmr::memory_resource* resource) = 0;
+
+        const void* _type;
+        slot* _next = nullptr;
+    };
+
+    template<typename T>
+    struct typedSlot : slot
+    {
+        explicit typedSlot(const T& value);
+
+        void release(std::pmr::memory_resource* resource) override;
+
+        T _value;
+    };
+
+    struct table
+    {
+        static table* create(size_t size, std::pmr::memory_resource* resource);
+        static void destroy(table* items);
+
+        table(size_t size, std::pmr::memory_resource* resource);
+        ~table();
+
+        std::pmr::memory_resource* _resource;
+        size_t _size;
+        std::atomic<slot*>* _slots;
+    };
+
+    // Its address identifies T, no RTTI is needed for the check
+    template<typename T>
+    static inline const char typeTag = 0;
+
+    mutable std::atomic<table*> _table{nullptr};
+};
+
+
+template<typename T>
+IniCache::typedSlot<T>::typedSlot(const T& value) : slot(&typeTag<T>), _value(value)
+{}
+
+template<typename T>
+void IniCache::typedSlot<T>::release(std::pmr::memory_resource* resource)
+{
+    std::pmr::polymorphic_allocator<typedSlot> allocator(resource);
+
+    this->~typedSlot();
+    allocator.deallocate(this, 1);
+}
+
+template<typename T>
+bool IniCache::find(size_t pos, T& value) const
+{
+    table* items = _table.load(std::memory_order_acquire);
+
+    if (items == nullptr || pos >= items->_size)
+    {
+        return false;
+    }
+
+    for (slot* item = items->_slots[pos].load(std::memory_order_acquire); item != nullptr; item = item->_next)
+    {
+        if (item->_type == &typeTag<T>)
+        {
+            value = static_cast<const typedSlot<T>*>(item)->_value;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template<typename T>
+void IniCache::insert(size_t pos, size_t keyCount, const T& value, std::pmr::memory_resource* resource) const
+{
+    table* items = _table.load(std::memory_order_acquire);
+
+    if (items == nullptr)
+    {
+        table* created = table::create(keyCount, resource);
+
+        if ( _table.compare_exchange_strong(items, created, std::memory_order_acq_rel, std::memory_order_acquire) )
+        {
+            items = created;
+        }
+        else
+        {
+            table::destroy(created);
+        }
+    }
+
+    if (pos >= items->_size)
+    {
+        return;
+    }
+
+    // Slots live as long as their table, so they come from its resource
+    std::pmr::polymorphic_allocator<typedSlot<T>> allocator(items->_resource);
+
+    typedSlot<T>* created = allocator.allocate(1);
+    allocator.construct(created, value);
+
+    slot* head = items->_slots[pos].load(std::memory_order_acquire);
+
+    do
+    {
+        // Another reader may have published the same type meanwhile
+        for (slot* item = head; item != nullptr; item = item->_next)
+        {
+            if (item->_type == &typeTag<T>)
+            {
+                created->release(items->_resource);
+                return;
+            }
+        }
+
+        created->_next = head;
+    }
+    while ( !items->_slots[pos].compare_exchange_weak(head, created, std::memory_order_release, std::memory_order_acquire) );
+}
+
+
+#endif //INICACHE_H
@@ -1,205 +1,948 @@
 #include "IniFile.h"
+#include "FrozenIniFile.h"
 
-IniFile::element::element(const IniSection& section) : _name(section), _lineNum(section.getLineNum())
+IniFile::element::element(const IniSection& section) : _name( section.getName() ), _lineNum( section.getLineNum() )
 {}
 
-IniFile::element::element(std::string  name, size_t lineNum) : _name( std::move(name) ), _lineNum(lineNum)
+IniFile::element::element(std::string_view name, size_t lineNum) : _name(name), _lineNum(lineNum)
 {}
 
+bool IniDiff::empty() const
+{
+    return _addedSections.empty() && _removedSections.empty() && _changedSections.empty() && _changedKeys.empty();
+}
+
 bool IniFile::element::operator==(const element& other) const
 {
+    // Names interned in the same pool share their address
+    if (_name.data() == other._name.data())
+    {
+        return _name.size() == other._name.size();
+    }
+
     return _name == other._name;
 }
 
-std::size_t IniFile::elementHash::operator()(const element& elem) const noexcept
-{
-return std::hash<std::string>{}(elem._name);
-}
+IniFile::keyMap::keyMap(std::pmr::memory_resource* resource) : _items(resource), _index(resource)
+{}
+
+IniFile::keyMap::keyMap(const keyMap& other, std::pmr::memory_resource* resource)
+        : _items(other._items, resource), _index(other._index, resource)
+{}
+
+IniFile::keyMap::iterator IniFile::keyMap::begin()
+{
+    return _items.begin();
+}
+
+IniFile::keyMap::iterator IniFile::keyMap::end()
+{
+    return _items.end();
+}
+
+IniFile::keyMap::const_iterator IniFile::keyMap::begin() const
+{
+    return _items.begin();
+}
+
+IniFile::keyMap::const_iterator IniFile::keyMap::end() const
+{
+    return _items.end();
+}
+
+size_t IniFile::keyMap::size() const
+{
+    return _items.size();
+}
+
+void IniFile::keyMap::reserve(size_t count)
+{
+    _items.reserve(count);
+}
+
+void IniFile::keyMap::fit()
+{
+    if (_items.capacity() > _items.size())
+    {
+        std::pmr::vector<value_type> items( _items.get_allocator() );
+        items.reserve( _items.size() );
+        items.assign( _items.begin(), _items.end() );
+
+        _items.swap(items);
+    }
+}
+
+IniFile::keyMap::iterator IniFile::keyMap::find(std::string_view name)
+{
+    return _items.begin() + position(name);
+}
+
+IniFile::keyMap::const_iterator IniFile::keyMap::find(std::string_view name) const
+{
+    return _items.begin() + position(name);
+}
+
+std::pair<IniFile::keyMap::iterator, bool> IniFile::keyMap::insert(value_type item)
+{
+    size_t pos = position(item.first._name);
+
+    if (pos != _items.size())
+    {
+        return {_items.begin() + pos, false};
+    }
+
+    _items.push_back( std::move(item) );
+
+    // The table is kept at most half full
+    if (_items.size() * 2 > _index.size() && _items.size() > linearLimit)
+    {
+        reindex();
+    }
+    else if ( !_index.empty() )
+    {
+        place( static_cast<uint32_t>(pos) );
+    }
+
+    return {_items.begin() + pos, true};
+}
+
+void IniFile::keyMap::reindex()
+{
+    _index.clear();
+
+    if (_items.size() <= linearLimit)
+    {
+        return;
+    }
+
+    size_t slots = linearLimit * 2;
+
+    while (slots < _items.size() * 2)
+    {
+        slots *= 2;
+    }
+
+    _index.assign(slots, emptySlot);
+
+    for (size_t pos = 0; pos < _items.size(); ++pos)
+    {
+        place( static_cast<uint32_t>(pos) );
+    }
+}
+
+void IniFile::keyMap::place(uint32_t pos)
+{
+    size_t mask = _index.size() - 1;
+    size_t slot = parser::seededHash(_items[pos].first._name) & mask;
+
+    while (_index[slot] != emptySlot)
+    {
+        slot = (slot + 1) & mask;
+    }
+
+    _index[slot] = pos;
+}
+
+size_t IniFile::keyMap::position(std::string_view name) const
+{
+    if ( !_index.empty() )
+    {
+        size_t mask = _index.size() - 1;
+
+        for (size_t slot = parser::seededHash(name) & mask; _index[slot] != emptySlot; slot = (slot + 1) & mask)
+        {
+            if (_items[_index[slot]].first._name == name)
+            {
+                return _index[slot];
+            }
+        }
+
+        return _items.size();
+    }
+
+    for (size_t pos = 0; pos < _items.size(); ++pos)
+    {
+        if (_items[pos].first._name == name)
+        {
+            return pos;
+        }
+    }
+
+    return _items.size();
+}
+
+IniFile::SectionRef::SectionRef(const sectionEntry* entry, IniNamePool* names) : _entry(entry), _names(names)
+{}
+
+std::string_view IniFile::SectionRef::getName() const
+{
+    return _entry->_element._name;
+}
+
+size_t IniFile::SectionRef::getIndex() const
+{
+    return _entry->_index;
+}
+
+size_t IniFile::SectionRef::getLineNum() const
+{
+    return _entry->_element._lineNum;
+}
+
+IniFile::KeyView IniFile::SectionRef::keys() const
+{
+    return {_entry->_keys.begin(), _entry->_keys.end()};
+}
+
+std::string_view IniFile::SectionRef::value(std::string_view key) const
+{
+    auto keyIt = _entry->_keys.find(key);
+    return keyIt == _entry->_keys.end() ? std::string_view() : keyIt->second;
+}
+
+IniFile::SectionRef::operator IniSection() const
+{
+    return {*_names->intern(_entry->_element._name), _entry->_index, _entry->_element._lineNum};
+}
+
+IniFile::KeyValue IniFile::toKeyValue::operator()(const keyMap::value_type& pair) const
+{
+    return {pair.first._name, pair.second, pair.first._lineNum};
+}
+
+IniFile::SectionRef IniFile::toSection::operator()(const sectionEntry& entry) const
+{
+    return SectionRef(&entry, _names);
+}
+
+IniFile::SectionRef IniFile::toDuplicate::operator()(size_t pos) const
+{
+    return SectionRef(_data + pos, _names);
+}
+
+IniFile::SectionRef IniFile::toSectionMatch::operator()(const IniNameIndex::entry& item) const
+{
+    return SectionRef(_data + item._section, _names);
+}
+
+IniFile::KeyMatch IniFile::toKeyMatch::operator()(const IniNameIndex::entry& item) const
+{
+    const auto& pair = *(_data[item._section]._keys.begin() + item._key);
+    return {SectionRef(_data + item._section, _names), {pair.first._name, pair.second, pair.first._lineNum}};
+}
+
+bool IniFile::fileStamp::operator==(const fileStamp& other) const
+{
+    return _size == other._size && _time == other._time;
+}
+
+std::size_t IniFile::elementHash::operator()(const element& elem) const noexcept
+{
+    return parser::seededHash(elem._name);
+}
+
+
+IniFile::IniFile(std::string  path, std::pmr::memory_resource* resource)
+        : _path( std::move(path) ), _resource(resource), _data(resource), _sectionIndex(resource), _arena(resource),
+          _patches(resource), _appended(resource), _sectionNames(resource), _keyNames(resource)
+{}
+
+IniFile::IniFile(const IniFile& other)
+        : _path(other._path), _resource(other._resource), _data(_resource), _sectionIndex(other._sectionIndex, _resource),
+          _arena(other._arena), _source(other._source), _patches(other._patches, _resource),
+          _appended(other._appended, _resource), _stamp(other._stamp), _mode(other._mode), _mapped(other._mapped),
+          _cacheEnabled(other._cacheEnabled), _sectionNames(other._sectionNames), _keyNames(other._keyNames),
+          _stats(other._stats), _names(other._names), _handleNames(other._handleNames)
+{
+    // sectionEntry isn't allocator-aware, a plain copy would put the keys on the default resource
+    _data.reserve( other._data.size() );
+
+    for (const auto& entry : other._data)
+    {
+        _data.push_back({entry._element, entry._index, keyMap(entry._keys, _resource), entry._region, entry._dirty,
+                         entry._regionHash});
+    }
+}
+
+IniFile& IniFile::operator=(const IniFile& other)
+{
+    if (this != &other)
+    {
+        IniFile copy(other);
+        *this = std::move(copy);
+    }
+
+    return *this;
+}
+
+IniFile& IniFile::operator=(IniFile&& other)
+{
+    if (this != &other)
+    {
+        // The move constructor takes the containers with their resource, nothing left can throw
+        this->~IniFile();
+        new (this) IniFile( std::move(other) );
+    }
+
+    return *this;
+}
+
+std::vector<IniSection> IniFile::operator[](const IniSection& name) const
+{
+    return this->sectionRange(name);
+}
+
+void IniFile::load(LoadMode mode, unsigned threadCount)
+{
+#if defined(INIFILE_STATS)
+    if (_stats)
+    {
+        auto [info, time] = measured([&](){ return loadSource(mode, threadCount); });
+        _stats->onLoad(_path, info._bytes, info._lines, time);
+
+        return;
+    }
+#endif
+
+    loadSource(mode, threadCount);
+}
+
+IniDiff IniFile::reload()
+{
+    IniDiff diff;
+
+#if defined(INIFILE_STATS)
+    if (_stats)
+    {
+        auto [info, time] = measured([&](){ return reloadSource(diff); });
+
+        if (info._bytes != 0)
+        {
+            _stats->onLoad(_path, info._bytes, info._lines, time);
+        }
+
+        return diff;
+    }
+#endif
+
+    reloadSource(diff);
+    return diff;
+}
+
+void IniFile::save() const
+{
+#if defined(INIFILE_STATS)
+    if (_stats)
+    {
+        auto [bytes, time] = measured([&](){ return saveText(); });
+        _stats->onSave(_path, bytes, time);
+
+        return;
+    }
+#endif
+
+    saveText();
+}
+
+void IniFile::saveChanges()
+{
+    if ( !_source )
+    {
+        save();
+        return;
+    }
+
+#if defined(INIFILE_STATS)
+    if (_stats)
+    {
+        auto [bytes, time] = measured([&](){ return patchText(); });
+        _stats->onSave(_path, bytes, time);
+
+        return;
+    }
+#endif
+
+    patchText();
+}
+
+IniFile::sourceInfo IniFile::loadSource(LoadMode mode, unsigned threadCount)
+{
+    constexpr size_t minChunkSize = 1 << 20;
+    size_t lineNum = 1;
+
+    fileStamp stamp = stampOf(_path);
+    auto buffer = IniBuffer::open(_path, mode, _resource);
+
+    std::pmr::vector<sectionEntry> data(_resource);
+    std::string_view text = buffer->view();
+
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    threadCount = static_cast<unsigned>( std::min<size_t>(threadCount, text.size() / minChunkSize + 1) );
+
+    if (threadCount == 1)
+    {
+        lineNum = parseChunk(text, 1, data);
+    }
+    else
+    {
+        // Every chunk but the first starts at a section header, so no section is split
+        std::vector<size_t> bounds{0};
+
+        for (unsigned i = 1; i < threadCount; ++i)
+        {
+            size_t pos = nextSectionStart(text, text.size() / threadCount * i);
+
+            if (pos > bounds.back() && pos < text.size())
+            {
+                bounds.push_back(pos);
+            }
+        }
+
+        bounds.push_back( text.size() );
+
+        size_t chunkCount = bounds.size() - 1;
+        std::vector<std::future<size_t>> lineCounts;
+
+        for (size_t i = 0; i < chunkCount; ++i)
+        {
+            lineCounts.push_back(std::async(std::launch::async, [text, begin = bounds[i], end = bounds[i + 1]](){
+                return static_cast<size_t>( std::count(text.begin() + begin, text.begin() + end, '\n') );
+            }));
+        }
+
+        std::vector<size_t> lineNums(chunkCount, 1);
+
+        for (size_t i = 0; i < chunkCount; ++i)
+        {
+            size_t count = lineCounts[i].get();
+
+            if (i + 1 < chunkCount)
+            {
+                lineNums[i + 1] = lineNums[i] + count;
+            }
+        }
+
+        std::vector<std::pmr::vector<sectionEntry>> parts;
+        parts.reserve(chunkCount);
+
+        for (size_t i = 0; i < chunkCount; ++i)
+        {
+            parts.emplace_back(_resource);
+        }
+        std::vector<std::future<size_t>> workers;
+
+        for (size_t i = 0; i < chunkCount; ++i)
+        {
+            workers.push_back(std::async(std::launch::async, [&, i](){
+                return parseChunk(text.substr(bounds[i], bounds[i + 1] - bounds[i]), lineNums[i], parts[i]);
+            }));
+        }
+
+        // Waiting in chunk order rethrows the error a sequential load would report
+        size_t sectionCount = 0;
+
+        for (size_t i = 0; i < chunkCount; ++i)
+        {
+            lineNum = workers[i].get();
+            sectionCount += parts[i].size();
+        }
+
+        data.reserve(sectionCount);
+
+        for (auto& part : parts)
+        {
+            data.insert(data.end(), std::make_move_iterator( part.begin() ), std::make_move_iterator( part.end() ));
+        }
+    }
+
+    _data = std::move(data);
+    adoptSource(buffer, mode, stamp);
+    rebuildIndex();
+
+    return {text.size(), lineNum - 1};
+}
+
+size_t IniFile::parseChunk(std::string_view text, size_t lineNum, std::pmr::vector<sectionEntry>& data)
+{
+    std::string_view first;
+    std::string_view second;
+
+    while ( !text.empty() )
+    {
+        const char* lineStart = text.data();
+
+        switch ( parser::readLine(text, first, second) )
+        {
+            case parser::lineType::section:
+                if ( !data.empty() )
+                {
+                    data.back()._region = {data.back()._region.data(), static_cast<size_t>(lineStart - data.back()._region.data())};
+                    data.back()._keys.fit();
+                }
+
+                data.push_back({{first, lineNum}, 0, keyMap( data.get_allocator().resource() ), {lineStart, 0}, false});
+                break;
+
+            case parser::lineType::keyValue:
+                addKeyValue(data.empty() ? nullptr : &data.back(), first, second, lineNum);
+                break;
+
+            default:
+                break;
+        }
+
+        ++lineNum;
+    }
+
+    if ( !data.empty() )
+    {
+        data.back()._region = {data.back()._region.data(), static_cast<size_t>(text.data() - data.back()._region.data())};
+        data.back()._keys.fit();
+    }
+
+    return lineNum;
+}
+
+size_t IniFile::nextSectionStart(std::string_view text, size_t pos)
+{
+    std::string_view first;
+    std::string_view second;
+
+    pos = text.find('\n', pos);
+
+    while (pos != std::string_view::npos && ++pos < text.size())
+    {
+        std::string_view rest = text.substr(pos);
+
+        if (parser::readLine(rest, first, second) == parser::lineType::section)
+        {
+            return pos;
+        }
+
+        pos = text.size() - rest.size() - 1;
+    }
+
+    return text.size();
+}
+
+IniFile::sourceInfo IniFile::reloadSource(IniDiff& diff)
+{
+    fileStamp stamp = stampOf(_path);
+
+    bool dirty = std::any_of(_data.begin(), _data.end(), [](const sectionEntry& entry){
+        return entry._dirty;
+    });
+
+    if (_stamp && *_stamp == stamp && !dirty)
+    {
+        return {0, 0};
+    }
+
+    auto buffer = IniBuffer::open(_path, _mode, _resource);
+
+    std::pmr::vector<sectionEntry> data(_resource);
+    std::string_view text = buffer->view();
+    std::string_view first;
+    std::string_view second;
+    size_t lineNum = 1;
+
+    while ( !text.empty() )
+    {
+        const char* lineStart = text.data();
+        parser::lineType type = parser::readLine(text, first, second);
+
+        if (type == parser::lineType::section)
+        {
+            if ( !data.empty() )
+            {
+                data.back()._region = {data.back()._region.data(), static_cast<size_t>(lineStart - data.back()._region.data())};
+            }
+
+            data.push_back({{first, lineNum}, 0, keyMap( data.get_allocator().resource() ), {lineStart, 0}, false});
+        }
+        else if (type == parser::lineType::keyValue && data.empty())
+        {
+            addKeyValue(nullptr, first, second, lineNum);
+        }
+
+        ++lineNum;
+    }
+
+    if ( !data.empty() )
+    {
+        data.back()._region = {data.back()._region.data(), static_cast<size_t>(text.data() - data.back()._region.data())};
+    }
+
+    constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    std::vector<size_t> reused( data.size(), npos );
+    std::vector<bool> matched( _data.size(), false );
+    std::unordered_map<std::string_view, size_t, parser::seededHasher> counts;
+
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        auto& entry = data[i];
+        entry._index = counts[entry._element._name]++;
+
+        auto old = getIterator(entry._element._name, entry._index);
+
+        if (old != _data.end())
+        {
+            matched[old - _data.begin()] = true;
+
+            if ( unchanged(*old, entry) )
+            {
+                reused[i] = old - _data.begin();
+                continue;
+            }
+        }
+
+        parseKeys(entry);
+
+        IniSection section = handle(entry._element._name, entry._index, entry._element._lineNum);
+
+        if (old == _data.end())
+        {
+            diff._addedSections.push_back(section);
+            continue;
+        }
+
+        diff._changedSections.push_back(section);
+
+        // The old keys are views into the mapping, which may already hold the new text
+        if (_mapped)
+        {
+            for (const auto& pair : entry._keys)
+            {
+                diff._changedKeys.emplace_back(section, std::string(pair.first._name));
+            }
+
+            continue;
+        }
+
+        for (const auto& pair : entry._keys)
+        {
+            auto oldKey = old->_keys.find(pair.first._name);
+
+            if (oldKey == old->_keys.end() || oldKey->second != pair.second)
+            {
+                diff._changedKeys.emplace_back(section, std::string(pair.first._name));
+            }
+        }
+
+        for (const auto& pair : old->_keys)
+        {
+            if (entry._keys.find(pair.first._name) == entry._keys.end())
+            {
+                diff._changedKeys.emplace_back(section, std::string(pair.first._name));
+            }
+        }
+    }
+
+    for (size_t pos = 0; pos < _data.size(); ++pos)
+    {
+        if ( !matched[pos] )
+        {
+            diff._removedSections.push_back( handle(_data[pos]._element._name, _data[pos]._index, _data[pos]._element._lineNum) );
+        }
+    }
+
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        if (reused[i] != npos)
+        {
+            data[i]._keys = std::move(_data[reused[i]]._keys);
+            data[i]._cache = std::move(_data[reused[i]]._cache);
+            rebase(data[i]._keys, _data[reused[i]], data[i]);
+        }
+    }
+
+    _data = std::move(data);
+    adoptSource(buffer, _mode, stamp);
+    rebuildIndex();
+
+    return {buffer->view().size(), lineNum - 1};
+}
+
+size_t IniFile::saveText() const
+{
+    size_t size = 0;
+
+    for (const auto& entry : _data)
+    {
+        size += entry._element._name.size() + 4;
+
+        for (const auto& pair : entry._keys)
+        {
+            size += pair.first._name.size() + pair.second.size() + 4;
+        }
+    }
+
+    std::string out;
+    out.reserve(size);
+
+    for (const auto& entry : _data)
+    {
+        out += '[';
+        out += entry._element._name;
+        out += "]\n";
+
+        for (const auto& pair : entry._keys)
+        {
+            out += pair.first._name;
+            out += " = ";
+            out += pair.second;
+            out += '\n';
+        }
+
+        out += '\n';
+    }
+
+    // Keys still view a mapped file, so it is replaced by rename and the mapping keeps the old text
+    std::string target = _mapped ? _path + ".tmp" : _path;
+
+    // Unbuffered, so the whole text goes out in one write
+    std::ofstream file;
+    file.rdbuf()->pubsetbuf(nullptr, 0);
+    file.open(target, std::ios::out | std::ios::trunc);
+
+    if ( !file.is_open() )
+    {
+        throw std::runtime_error("can't save IniFile");
+    }
+
+    file.write( out.data(), static_cast<std::streamsize>( out.size() ) );
+    file.close();
+
+    if ( !file )
+    {
+        throw std::runtime_error("can't save IniFile");
+    }
+
+    if (_mapped)
+    {
+        std::filesystem::rename(target, _path);
+    }
 
+    // The loaded text no longer matches the file, so the next saveChanges() saves everything
+    _source.reset();
+    _patches.clear();
+    _appended.clear();
+    _stamp = stampOf(_path);
 
-IniFile::IniFile(std::string  path) : _path( std::move(path) )
-{}
+    return out.size();
+}
 
-std::vector<IniSection> IniFile::operator[](const IniSection& name)
+std::future<void> IniFile::loadAsync(LoadMode mode, unsigned threadCount, IniExecutor executor)
 {
-    return this->sectionRange(name);
+    return runAsync(executor, [this, mode, threadCount](){ load(mode, threadCount); });
 }
 
-void IniFile::load()
+std::future<IniDiff> IniFile::reloadAsync(IniExecutor executor)
 {
-    std::ios_base::sync_with_stdio(false);
+    return runAsync(executor, [this](){ return reload(); });
+}
 
-    std::fstream file;
-    file.open(_path);
+std::future<void> IniFile::saveAsync(IniExecutor executor) const
+{
+    return runAsync(executor, [this](){ save(); });
+}
 
-    if ( !file.is_open() )
+size_t IniFile::patchText()
+{
+    if ( !(stampOf(_path) == *_stamp) )
     {
-        throw std::runtime_error("can't open IniFile: " + _path);
+        throw std::runtime_error("IniFile changed since load: " + _path);
     }
 
-    size_t lineNum = 1;
-    std::string line;
+    struct edit
+    {
+        size_t _offset;
+        size_t _length;
+        size_t* _written;
+        std::string _text;
+        bool _pending;
+    };
 
-    auto sectionIt = _data.end();
-    std::string section;
-    std::string key;
-    std::string value;
+    std::string_view text = _source->view();
+    std::vector<edit> edits;
 
-    while ( getline(file, line) )
+    for (auto& item : _patches)
     {
-        size_t leftBracketPos = line.find_first_of('[');
-        size_t rightBracketPos = line.find_first_of(']');
+        auto keyIt = _data[item._section]._keys.find(item._key);
+        std::string line;
+
+        // The arena never reuses its bytes, so the same view is the value already in the file
+        bool pending = !item._applied || keyIt->second.data() != item._saved.data() ||
+                       keyIt->second.size() != item._saved.size();
 
-        if (leftBracketPos != std::string::npos && rightBracketPos != std::string::npos)
+        if (item._length == 0)
         {
-            section = line.substr(leftBracketPos + 1, line.find_last_of(']') - line.find_first_of('[') - 1);
-            sectionIt = _data.insert({{section, lineNum}, {}});
-            ++lineNum;
-            continue;
+            line.append(keyIt->first._name).append(" = ").append(keyIt->second) += '\n';
+        }
+        else
+        {
+            line = keyIt->second;
+            line.resize(std::max(line.size(), item._written), ' ');
         }
 
-        size_t equalPos = line.find_first_of('=');
+        edits.push_back({item._offset, item._length, &item._written, std::move(line), pending});
+    }
 
-        if (equalPos != std::string::npos)
-        {
-            key = readWord( line.substr(0, equalPos) );
-            value = readWord( line.substr(equalPos + 1) );
+    // Written with writeSection() after the load, they follow the loaded ones
+    _appended.resize(std::count_if(_data.begin(), _data.end(), [](const sectionEntry& entry) {
+        return entry._region.empty();
+    }), 0);
 
-            if (key.empty() || value.empty())
-            {
-                throw std::runtime_error("empty key or value in line: " + std::to_string(lineNum));
-            }
+    size_t appended = 0;
 
-            if (sectionIt == _data.end())
-            {
-                throw std::runtime_error("key and value without section in line: " + std::to_string(lineNum));
-            }
+    for (const auto& entry : _data)
+    {
+        if (entry._region.empty())
+        {
+            std::string section;
+            section.append("\n[").append(entry._element._name) += "]\n";
 
-            if (sectionIt->second.find(key) != sectionIt->second.end())
+            for (const auto& pair : entry._keys)
             {
-                throw std::runtime_error("duplicate key in line: " + std::to_string(lineNum));
+                section.append(pair.first._name).append(" = ").append(pair.second) += '\n';
             }
 
-            sectionIt->second.insert({{key, lineNum}, value});
+            edits.push_back({text.size(), 0, &_appended[appended++], std::move(section), true});
         }
-
-        ++lineNum;
     }
-}
 
-void IniFile::save() const
-{
-    std::ios_base::sync_with_stdio(false);
-
-    std::fstream file;
-    file.open(_path, std::ios::out);
+    std::stable_sort(edits.begin(), edits.end(), [](const edit& left, const edit& right) {
+        return left._offset < right._offset;
+    });
 
-    if ( !file.is_open() )
+    // Nothing to separate the first section from
+    if (text.empty() && !edits.empty())
     {
-        throw std::runtime_error("can't save IniFile");
+        edits.front()._text.erase(0, 1);
     }
 
-    std::vector<std::pair<element, std::vector<std::pair<element, std::string>>>> arr;
-    arr.reserve( _data.size() );
-
-    for (auto& pair : _data)
+    for (auto& item : edits)
     {
-        arr.push_back({pair.first, {}});
-        arr.back().second.reserve( pair.second.size() );
-
-        for (auto& keyVal : pair.second)
+        if (item._offset == text.size() && !text.empty() && text.back() != '\n')
         {
-            arr.back().second.emplace_back(keyVal.first, keyVal.second);
+            item._text.insert(0, 1, '\n');
+            break;
         }
+    }
+
+    // The file holds every edit as it was last written, so a loaded offset is shifted by what the
+    // edits before it added. Edits up to the first one that changes size are written in place
+    size_t shift = 0;
+    auto grown = edits.begin();
 
-        std::sort(arr.back().second.begin(), arr.back().second.end(),
-                  [](const std::pair<element, std::string>& a, const std::pair<element, std::string>& b){
-                      return a.first._lineNum < b.first._lineNum;
-                  });
+    while (grown != edits.end() && grown->_text.size() == *grown->_written)
+    {
+        shift += *grown->_written - grown->_length;
+        ++grown;
     }
 
-    std::sort(arr.begin(), arr.end(), [](const std::pair<element, std::vector<std::pair<element, std::string>>>& a,
-    const std::pair<element, std::vector<std::pair<element, std::string>>>& b){
-        return a.first._lineNum < b.first._lineNum;
-    });
+    // Built before anything is written, a mapped file changes under the view
+    std::string tail;
 
-    for (const auto& item : arr)
+    if (grown != edits.end())
     {
-        file << '[' << item.first._name << ']' << '\n';
+        size_t pos = grown->_offset;
 
-        for (auto&& pair : item.second)
+        for (auto it = grown; it != edits.end(); ++it)
         {
-            file << pair.first._name << " = " << pair.second << '\n';
+            tail.append( text.substr(pos, it->_offset - pos) ) += it->_text;
+            pos = it->_offset + it->_length;
         }
 
-        file << '\n';
+        tail += text.substr(pos);
     }
-}
 
-template<>
-char IniFile::read(const IniSection& section, const std::string& key, char defaultValue)
-{
-    auto pairIt = getIterator(section);
+    std::fstream file;
+    file.rdbuf()->pubsetbuf(nullptr, 0);
+    file.open(_path, std::ios::in | std::ios::out | std::ios::binary);
 
-    if (pairIt == _data.end() || pairIt->second.find(key) == pairIt->second.end())
+    if ( !file.is_open() )
     {
-        return defaultValue;
+        throw std::runtime_error("can't save IniFile");
     }
 
-    if (pairIt->second[key].size() > 1)
+    size_t written = 0;
+    size_t offset = 0;
+
+    for (auto it = edits.begin(); it != grown; ++it)
     {
-        throw std::runtime_error( addLineNum(pairIt, key, "more than one character") );
+        if (it->_pending)
+        {
+            file.seekp( static_cast<std::streamoff>(it->_offset + offset) );
+            file.write( it->_text.data(), static_cast<std::streamsize>( it->_text.size() ) );
+            written += it->_text.size();
+        }
+
+        offset += *it->_written - it->_length;
     }
 
-    return pairIt->second[key].front();
-}
+    if (grown != edits.end())
+    {
+        file.seekp( static_cast<std::streamoff>(grown->_offset + shift) );
+        file.write( tail.data(), static_cast<std::streamsize>( tail.size() ) );
+        written += tail.size();
+    }
 
-template<>
-bool IniFile::read(const IniSection& section, const std::string& key, bool defaultValue)
-{
-    auto it = getIterator(section);
+    file.close();
 
-    if (it == _data.end() || it->second.find(key) == it->second.end())
+    if ( !file )
     {
-        return defaultValue;
+        throw std::runtime_error("can't save IniFile");
     }
 
-    std::string valueCopy = it->second[key];
-    std::transform(valueCopy.begin(), valueCopy.end(), valueCopy.begin(), [](unsigned char c){
-        return std::tolower(c);
-    });
-
-    if (std::find(alias::trueValue.begin(), alias::trueValue.end(), valueCopy) != alias::trueValue.end())
+    if (grown != edits.end() && grown->_offset + shift + tail.size() < _stamp->_size)
     {
-        return true;
+        std::filesystem::resize_file(_path, grown->_offset + shift + tail.size());
     }
 
-    return false;
-}
+    // A mapped view shows the rewritten tail, so its keys no longer hold their text
+    if (grown != edits.end() && _source->isMapped())
+    {
+        loadSource(_mode, 1);
+        return written;
+    }
 
-template<>
-std::string IniFile::read(const IniSection& section, const std::string& key, std::string defaultValue)
-{
-    auto it = getIterator(section);
+    for (auto& item : edits)
+    {
+        *item._written = item._text.size();
+    }
 
-    if (it == _data.end() || it->second.find(key) == it->second.end())
+    for (auto& item : _patches)
     {
-        return defaultValue;
+        item._saved = _data[item._section]._keys.find(item._key)->second;
+        item._applied = true;
     }
 
-    return it->second[key];
+    _stamp = stampOf(_path);
+
+    return written;
 }
 
 IniSection IniFile::writeSection(const std::string& section)
 {
-    auto it = _data.insert({section, {}});
-    return {section, getIteratorIndex(it)};
+    auto it = insertSection(storeName(section), 0);
+    return handle(section, it->_index, 0);
+}
+
+FrozenIniFile IniFile::freeze() const
+{
+    return FrozenIniFile(*this);
 }
 
 template<>
-void IniFile::writeKeyValue(const IniSection& section, const std::string& key, bool value)
+void IniFile::writeKeyValue(const IniSection& section, std::string_view key, bool value)
 {
-    auto it = getIterator(section);
+    auto it = getIterator( section.getName(), section.getIndex() );
 
     if (it == _data.end())
     {
@@ -208,30 +951,30 @@ void IniFile::writeKeyValue(const IniSection& section, const std::string& key, b
 
     if (value)
     {
-        it->second[key] = alias::computerTruePrint;
+        writeValue(it, key, alias::computerTruePrint);
     }
     else
     {
-        it->second[key] = alias::computerFalsePrint;
+        writeValue(it, key, alias::computerFalsePrint);
     }
 }
 
 template<>
-void IniFile::writeKeyValue(const IniSection& section, const std::string& key, const std::string& value)
+void IniFile::writeKeyValue(const IniSection& section, std::string_view key, const std::string& value)
 {
-    auto it = getIterator(section);
+    auto it = getIterator( section.getName(), section.getIndex() );
 
     if (it == _data.end())
     {
         return;
     }
 
-    it->second[key] = value;
+    writeValue(it, key, value);
 }
 
-bool IniFile::sectionExists(const IniSection& section)
+bool IniFile::sectionExists(const IniSection& section) const
 {
-    auto it = getIterator(section);
+    auto it = getIterator( section.getName(), section.getIndex() );
 
     if (it == _data.end())
     {
@@ -241,16 +984,42 @@ bool IniFile::sectionExists(const IniSection& section)
     return true;
 }
 
-bool IniFile::keyExists(const IniSection& section, const std::string& key)
+void IniFile::setStatsSink(std::shared_ptr<IniStatsSink> sink)
+{
+    _stats = std::move(sink);
+}
+
+void IniFile::setNamePool(std::shared_ptr<IniNamePool> pool)
+{
+    _names = std::move(pool);
+}
+
+void IniFile::enableCache(bool enabled)
+{
+    _cacheEnabled = enabled;
+
+    if ( !enabled )
+    {
+        for (auto& entry : _data)
+        {
+            entry._cache.clear();
+        }
+    }
+}
+
+bool IniFile::keyExists(const IniSection& section, std::string_view key) const
 {
-    auto it = getIterator(section);
+    return keyExists(getIterator( section.getName(), section.getIndex() ), key);
+}
 
+bool IniFile::keyExists(constDataIterator it, std::string_view key) const
+{
     if (it == _data.end())
     {
         return false;
     }
 
-    if (it->second.find(key) == it->second.end())
+    if (it->_keys.find(key) == it->_keys.end())
     {
         return false;
     }
@@ -258,29 +1027,95 @@ bool IniFile::keyExists(const IniSection& section, const std::string& key)
     return true;
 }
 
-std::vector<IniSection> IniFile::sections()
+std::vector<IniSection> IniFile::sections() const
 {
     std::vector<IniSection> sections;
 
-    for (auto it = _data.begin(); it != _data.end(); ++it)
+    sections.reserve( _data.size() );
+
+    for (const auto& entry : _data)
     {
-        sections.emplace_back(it->first._name, getIteratorIndex(it), it->first._lineNum);
+        sections.push_back( handle(entry._element._name, entry._index, entry._element._lineNum) );
     }
 
     return sections;
 }
 
-std::vector<IniSection> IniFile::sectionRange(const IniSection& section)
+IniFile::SectionView IniFile::sectionsView() const
+{
+    return {_data.begin(), _data.end(), {handleNames()}};
+}
+
+IniFile::RangeView IniFile::sectionRangeView(const IniSection& section) const
+{
+    auto indexIt = _sectionIndex.find(section);
+
+    if (indexIt == _sectionIndex.end())
+    {
+        return {{}, {}, {_data.data(), handleNames()}};
+    }
+
+    return {indexIt->second.begin(), indexIt->second.end(), {_data.data(), handleNames()}};
+}
+
+IniFile::KeyView IniFile::keysView(const IniSection& section) const
+{
+    auto it = getIterator( section.getName(), section.getIndex() );
+
+    if (it == _data.end())
+    {
+        return {{}, {}};
+    }
+
+    return {it->_keys.begin(), it->_keys.end()};
+}
+
+IniFile::SectionMatchView IniFile::sectionsMatching(std::string_view pattern) const
+{
+    auto [first, last] = _sectionNames.match(pattern, [this](std::pmr::vector<IniNameIndex::entry>& entries) {
+        entries.reserve( _data.size() );
+
+        for (size_t pos = 0; pos < _data.size(); ++pos)
+        {
+            entries.push_back({_data[pos]._element._name, pos, 0});
+        }
+    });
+
+    return {first, last, {_data.data(), handleNames()}};
+}
+
+IniFile::KeyMatchView IniFile::keysMatching(std::string_view pattern) const
+{
+    auto [first, last] = _keyNames.match(pattern, [this](std::pmr::vector<IniNameIndex::entry>& entries) {
+        for (size_t pos = 0; pos < _data.size(); ++pos)
+        {
+            size_t key = 0;
+
+            for (const auto& pair : _data[pos]._keys)
+            {
+                entries.push_back({pair.first._name, pos, key++});
+            }
+        }
+    });
+
+    return {first, last, {_data.data(), handleNames()}};
+}
+
+std::vector<IniSection> IniFile::sectionRange(const IniSection& section) const
 {
     std::vector<IniSection> sectionsArr;
-    size_t index = 0;
-    auto pairIt = _data.equal_range(section);
+    auto indexIt = _sectionIndex.find(section);
 
-    while (pairIt.first != pairIt.second)
+    if (indexIt == _sectionIndex.end())
     {
-        sectionsArr.emplace_back(section, index, pairIt.first->first._lineNum);
-        ++index;
-        ++pairIt.first;
+        return sectionsArr;
+    }
+
+    sectionsArr.reserve( indexIt->second.size() );
+
+    for (size_t pos : indexIt->second)
+    {
+        sectionsArr.push_back( handle(section.getName(), _data[pos]._index, _data[pos]._element._lineNum) );
     }
 
     return sectionsArr;
@@ -288,30 +1123,33 @@ std::vector<IniSection> IniFile::sectionRange(const IniSection& section)
 
 size_t IniFile::sectionCount(const IniSection& section) const
 {
-    auto pairIt = _data.equal_range(section);
+    auto indexIt = _sectionIndex.find(section);
 
-    if (pairIt.first == _data.end() && pairIt.second == _data.end())
+    if (indexIt == _sectionIndex.end())
     {
         return 0;
     }
 
-    return std::distance(pairIt.first, pairIt.second);
+    return indexIt->second.size();
 }
 
-std::vector<std::string> IniFile::keys(const IniSection& section)
+std::vector<std::string> IniFile::keys(const IniSection& section) const
 {
-    std::vector<std::string> keys;
+    return keys( getIterator( section.getName(), section.getIndex() ) );
+}
 
-    auto it = getIterator(section);
+std::vector<std::string> IniFile::keys(constDataIterator it) const
+{
+    std::vector<std::string> keys;
 
     if (it == _data.end())
     {
         return keys;
     }
 
-    keys.reserve( it->second.size() );
+    keys.reserve( it->_keys.size() );
 
-    for (auto& pair : it->second)
+    for (auto& pair : it->_keys)
     {
         keys.emplace_back(pair.first._name);
     }
@@ -319,78 +1157,295 @@ std::vector<std::string> IniFile::keys(const IniSection& section)
     return keys;
 }
 
-size_t IniFile::getKeyLineNum(const IniSection& section, const std::string& key)
+size_t IniFile::getKeyLineNum(const IniSection& section, std::string_view key) const
 {
-    auto it = getIterator(section);
+    return getKeyLineNum(getIterator( section.getName(), section.getIndex() ), key);
+}
 
+size_t IniFile::getKeyLineNum(constDataIterator it, std::string_view key) const
+{
     if (it == _data.end())
     {
         return 0;
     }
 
-    return it->second.find(key)->first._lineNum;
+    auto keyIt = it->_keys.find(key);
+
+    if (keyIt == it->_keys.end())
+    {
+        return 0;
+    }
+
+    return keyIt->first._lineNum;
 }
 
-std::string IniFile::readWord(const std::string& line)
+void IniFile::addKeyValue(sectionEntry* entry, std::string_view key, std::string_view value, size_t lineNum)
 {
-    if ( line.empty() )
+    if (key.empty() || value.empty())
+    {
+        throw std::runtime_error("empty key or value in line: " + std::to_string(lineNum));
+    }
+
+    if (entry == nullptr)
+    {
+        throw std::runtime_error("key and value without section in line: " + std::to_string(lineNum));
+    }
+
+    if ( !entry->_keys.insert({{key, lineNum}, value}).second )
     {
-        return {};
+        throw std::runtime_error("duplicate key in line: " + std::to_string(lineNum));
     }
+}
+
+void IniFile::parseKeys(sectionEntry& entry)
+{
+    std::string_view text = entry._region;
+    std::string_view first;
+    std::string_view second;
+    size_t lineNum = entry._element._lineNum + 1;
 
-    size_t startPos = 0;
-    size_t endPos = line.size();
+    parser::nextLine(text);
 
-    for (const auto& item : line)
+    while ( !text.empty() )
     {
-        if (item != ' ')
+        if (parser::readLine(text, first, second) == parser::lineType::keyValue)
         {
-            break;
+            addKeyValue(&entry, first, second, lineNum);
         }
 
-        ++startPos;
+        ++lineNum;
     }
 
-    for (auto it = line.rbegin(); it != line.rend(); ++it)
+    entry._keys.fit();
+}
+
+void IniFile::rebase(keyMap& keys, const sectionEntry& from, const sectionEntry& to)
+{
+    // Interned keys don't point into the old text, internSource() copies them again
+    if (from._region.data() == nullptr)
     {
-        if (*it != ' ')
+        for (auto& pair : keys)
         {
-            break;
+            pair.first._lineNum += to._element._lineNum - from._element._lineNum;
         }
 
-        --endPos;
+        return;
+    }
+
+    auto move = [&from, &to](std::string_view text) {
+        return std::string_view(to._region.data() + (text.data() - from._region.data()), text.size());
+    };
+
+    for (auto& pair : keys)
+    {
+        pair.first._name = move(pair.first._name);
+        pair.first._lineNum += to._element._lineNum - from._element._lineNum;
+        pair.second = move(pair.second);
     }
 
-    if ( line.find(parser::commentStart) != std::string::npos)
+    keys.reindex();
+}
+
+IniFile::fileStamp IniFile::stampOf(const std::string& path)
+{
+    std::error_code error;
+
+    auto size = std::filesystem::file_size(path, error);
+    auto time = std::filesystem::last_write_time(path, error);
+
+    return {size, time};
+}
+
+void IniFile::rebuildIndex()
+{
+    _sectionIndex.clear();
+    dropNameIndex();
+
+    for (size_t pos = 0; pos < _data.size(); ++pos)
     {
-        return line.substr(startPos, line.find(parser::commentStart) - 1);
+        auto& positions = _sectionIndex[_data[pos]._element];
+
+        _data[pos]._index = positions.size();
+        positions.push_back(pos);
     }
+}
 
-    return line.substr(startPos, endPos);
+void IniFile::dropNameIndex()
+{
+    _sectionNames.clear();
+    _keyNames.clear();
 }
 
-IniFile::dataIterator IniFile::getIterator(const IniSection& section)
+void IniFile::adoptSource(const std::shared_ptr<const IniBuffer>& buffer, LoadMode mode, const fileStamp& stamp)
 {
-    auto it = _data.equal_range(section);
+    IniArena arena(_resource);
 
-    if (it.first == _data.end() && it.second == _data.end() || section.getIndex() >= std::distance(it.first, it.second) + 1)
+    if (_names)
     {
-        return _data.end();
+        internSource(arena);
+    }
+    else
+    {
+        arena.adopt(buffer);
+
+        if ( buffer->isMapped() )
+        {
+            fingerprintSource(arena);
+        }
+    }
+
+    _arena = std::move(arena);
+    _source = _names ? nullptr : buffer;
+    _mapped = !_names && buffer->isMapped();
+    _patches.clear();
+    _appended.clear();
+
+    _mode = mode;
+    _stamp = stamp;
+}
+
+void IniFile::internSource(IniArena& arena)
+{
+    for (auto& entry : _data)
+    {
+        entry._element._name = *_names->intern(entry._element._name);
+
+        if (entry._region.data() != nullptr)
+        {
+            entry._regionHash = std::hash<std::string_view>{}(entry._region);
+            entry._region = {};
+        }
+
+        for (auto& pair : entry._keys)
+        {
+            pair.first._name = *_names->intern(pair.first._name);
+            pair.second = arena.store(pair.second);
+        }
+
+        entry._keys.reindex();
+    }
+}
+
+void IniFile::fingerprintSource(IniArena& arena)
+{
+    // Names are copied so the section index and a later diff never read the mapping
+    for (auto& entry : _data)
+    {
+        entry._element._name = arena.store(entry._element._name);
+        entry._regionHash = std::hash<std::string_view>{}(entry._region);
+    }
+}
+
+bool IniFile::unchanged(const sectionEntry& old, const sectionEntry& entry) const
+{
+    if (old._dirty)
+    {
+        return false;
+    }
+
+    if (old._region.data() == nullptr)
+    {
+        return _names && old._regionHash == std::hash<std::string_view>{}(entry._region);
+    }
+
+    if (_mapped)
+    {
+        return old._regionHash == std::hash<std::string_view>{}(entry._region);
+    }
+
+    return old._region == entry._region;
+}
+
+bool IniFile::inSource(std::string_view text) const
+{
+    auto source = _source->view();
+    std::less<const char*> less;
+
+    return !less(text.data(), source.data()) && less(text.data(), source.data() + source.size());
+}
+
+size_t IniFile::offsetOf(std::string_view text) const
+{
+    return static_cast<size_t>( std::distance(_source->view().data(), text.data()) );
+}
+
+std::string_view IniFile::storeName(std::string_view name)
+{
+    return _names ? std::string_view( *_names->intern(name) ) : _arena.store(name);
+}
+
+IniNamePool* IniFile::handleNames() const
+{
+    return _names ? _names.get() : _handleNames.get();
+}
+
+IniSection IniFile::handle(std::string_view name, size_t index, size_t lineNum) const
+{
+    return {*handleNames()->intern(name), index, lineNum};
+}
+
+void IniFile::writeValue(dataIterator it, std::string_view key, std::string_view value)
+{
+    auto keyIt = it->_keys.find(key);
+    size_t section = it - _data.begin();
+
+    if (keyIt == it->_keys.end())
+    {
+        auto name = storeName(key);
+        it->_keys.insert({name, _arena.store(value)});
+        it->_cache.clear();
+        it->_dirty = true;
+        _keyNames.clear();
+
+        if (_source && !it->_region.empty())
+        {
+            _patches.push_back({offsetOf(it->_region) + it->_region.size(), 0, 0, section, name});
+        }
+
+        return;
+    }
+
+    if (_source && inSource(keyIt->second))
+    {
+        _patches.push_back({offsetOf(keyIt->second), keyIt->second.size(), keyIt->second.size(), section, keyIt->first._name});
     }
 
-    std::advance(it.first, section.getIndex());
+    it->_cache.erase(keyIt - it->_keys.begin());
+    keyIt->second = _arena.store(value);
+    it->_dirty = true;
+}
+
+IniFile::dataIterator IniFile::insertSection(std::string_view name, size_t lineNum)
+{
+    auto& positions = _sectionIndex[name];
+
+    positions.push_back( _data.size() );
+    _data.push_back({{name, lineNum}, positions.size() - 1, keyMap(_resource), {}, true});
+    dropNameIndex();
 
-    return it.first;
+    return std::prev( _data.end() );
 }
 
-size_t IniFile::getIteratorIndex(dataIterator it)
+IniFile::dataIterator IniFile::getIterator(std::string_view name, size_t index)
 {
-    auto firstIt = _data.equal_range(it->first._name).first;
-    return std::distance(firstIt, it);
+    auto it = static_cast<const IniFile&>(*this).getIterator(name, index);
+    return _data.begin() + std::distance(_data.cbegin(), it);
+}
+
+IniFile::constDataIterator IniFile::getIterator(std::string_view name, size_t index) const
+{
+    auto indexIt = _sectionIndex.find(name);
+
+    if (indexIt == _sectionIndex.end() || index >= indexIt->second.size())
+    {
+        return _data.end();
+    }
+
+    return _data.begin() + indexIt->second[index];
 }
 
-std::string IniFile::addLineNum(dataIterator it, const std::string& key, const std::string& message)
+std::string IniFile::addLineNum(constDataIterator it, std::string_view key, const std::string& message) const
 {
 
-    return message + " in line: " + std::to_string(it->second.find(key)->first._lineNum);
+    return message + " in line: " + std::to_string(it->_keys.find(key)->first._lineNum);
 }
\ No newline at end of file
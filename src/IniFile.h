@@ -2,41 +2,79 @@
 #define INIFILE_H
 
 #include "IniSection.h"
+#include "IniNamePool.h"
+#include "IniArena.h"
+#include "IniCache.h"
+#include "IniValue.h"
+#include "IniParser.h"
+#include "IniView.h"
+#include "IniStats.h"
+#include "IniNameIndex.h"
+#include "IniHash.h"
 
 #include <array>
+#include <cstdint>
+#include <string_view>
+#include <filesystem>
+#include <optional>
+#include <limits>
+#include <future>
+#include <thread>
 #include <vector>
 #include <unordered_map>
+#include <memory_resource>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 #include <type_traits>
 #include <cctype>
+#include <functional>
 
 
-namespace parser
+// Binds a key of a section to a member of Owner, see IniFile::readFields
+template<typename Owner, typename T>
+struct IniField
 {
-    constexpr auto numSeparator = '.';
-    constexpr auto commentStart = ';';
-    constexpr auto minus = '-';
-}
+    std::string_view _key;
+    T Owner::* _member;
+    T _defaultValue;
+};
 
-namespace alias
+template<typename Owner, typename T>
+IniField<Owner, T> iniField(std::string_view key, T Owner::* member, std::common_type_t<T> defaultValue = T{})
 {
-    constexpr std::array<const char*, 4> trueValue = {"true", "on", "yes", "1"};
-    constexpr auto computerTruePrint = "true";
-    constexpr auto computerFalsePrint = "false";
+    return {key, member, std::move(defaultValue)};
 }
 
 
+struct IniDiff
+{
+    std::vector<IniSection> _addedSections;
+    std::vector<IniSection> _removedSections;
+    std::vector<IniSection> _changedSections;
+    std::vector<std::pair<IniSection, std::string>> _changedKeys;
+
+    bool empty() const;
+};
+
+
+class FrozenIniFile;
+
+// Runs a task on another thread, for example by posting it to an event loop's worker pool
+using IniExecutor = std::function<void(std::function<void()>)>;
+
 class IniFile
 {
+    friend class FrozenIniFile;
+    friend class IniBuilder;
+
 private:
     struct element
     {
         element(const IniSection& section);
-        element(std::string name, size_t lineNum = 0);
+        element(std::string_view name, size_t lineNum = 0);
 
-        std::string _name;
+        std::string_view _name;
         size_t _lineNum;
 
         bool operator==(const element& other) const;
@@ -47,115 +85,557 @@ private:
         std::size_t operator()(const element& elem) const noexcept;
     };
 
+    // Keys in file and insertion order, small sections are searched linearly and larger ones get an
+    // open-addressed table of positions into _items, so a name is stored only once
+    class keyMap
+    {
+    public:
+        using value_type = std::pair<element, std::string_view>;
+        using iterator = std::pmr::vector<value_type>::iterator;
+        using const_iterator = std::pmr::vector<value_type>::const_iterator;
+
+        keyMap() = default;
+        explicit keyMap(std::pmr::memory_resource* resource);
+        keyMap(const keyMap& other, std::pmr::memory_resource* resource);
+
+        iterator begin();
+        iterator end();
+        const_iterator begin() const;
+        const_iterator end() const;
+
+        size_t size() const;
+        void reserve(size_t count);
+
+        // Drops the capacity left over from growing, once all keys of the section are in
+        void fit();
+
+        iterator find(std::string_view name);
+        const_iterator find(std::string_view name) const;
+
+        std::pair<iterator, bool> insert(value_type item);
+
+        // Must follow any change of the stored names
+        void reindex();
+
+    private:
+        static constexpr size_t linearLimit = 8;
+        static constexpr uint32_t emptySlot = std::numeric_limits<uint32_t>::max();
+
+        std::pmr::vector<value_type> _items;
+        std::pmr::vector<uint32_t> _index;
+
+        size_t position(std::string_view name) const;
+        void place(uint32_t pos);
+    };
+
+    struct sectionEntry
+    {
+        element _element;
+        size_t _index;
+        keyMap _keys;
+
+        std::string_view _region;
+        bool _dirty;
+
+        // Hash of _region taken at load, for text dropped after interning or mapped text a writer may change
+        size_t _regionHash = 0;
+
+        // Parsed values of read<T> by key position, filled when the cache is enabled
+        IniCache _cache{};
+    };
+
+    struct fileStamp
+    {
+        std::uintmax_t _size;
+        std::filesystem::file_time_type _time;
+
+        bool operator==(const fileStamp& other) const;
+    };
+
+    // A value of the loaded file replaced in memory, or a key line to insert when _length is 0.
+    // _offset and _length are in the loaded text, _written is what the edit covers in the file now.
+    // Once saved it stays for the offsets after it, and is written again only when _saved changes
+    struct patch
+    {
+        size_t _offset;
+        size_t _length;
+        size_t _written;
+        size_t _section;
+        std::string_view _key;
+        std::string_view _saved{};
+        bool _applied = false;
+    };
+
+    template<typename S>
+    using sectionName = std::enable_if_t<std::is_convertible_v<const S&, std::string_view>, int>;
+
+    using dataIterator = std::pmr::vector<sectionEntry>::iterator;
+    using constDataIterator = std::pmr::vector<sectionEntry>::const_iterator;
+
+    struct toKeyValue;
+    struct toSection;
+    struct toDuplicate;
+    struct toSectionMatch;
+    struct toKeyMatch;
+
 public:
-    explicit IniFile(std::string path);
+    struct KeyValue
+    {
+        std::string_view _key;
+        std::string_view _value;
+        size_t _lineNum;
+    };
+
+    class SectionRef;
+    struct KeyMatch;
+
+    // Views point into the IniFile and are valid until it is modified or reloaded
+    using KeyView = IniView<keyMap::const_iterator, toKeyValue>;
+    using SectionView = IniView<constDataIterator, toSection>;
+    using RangeView = IniView<std::pmr::vector<size_t>::const_iterator, toDuplicate>;
+    using SectionMatchView = IniView<IniNameIndex::iterator, toSectionMatch>;
+    using KeyMatchView = IniView<IniNameIndex::iterator, toKeyMatch>;
+
+    class SectionRef
+    {
+    public:
+        std::string_view getName() const;
+        size_t getIndex() const;
+        size_t getLineNum() const;
+
+        KeyView keys() const;
 
-    std::vector<IniSection> operator[](const IniSection& name);
+        // Raw stored text, empty when the key is missing
+        std::string_view value(std::string_view key) const;
 
-    void load();
+        // The handle stays valid while the IniFile lives, like those of sections()
+        operator IniSection() const;
+
+    private:
+        friend class IniFile;
+
+        SectionRef(const sectionEntry* entry, IniNamePool* names);
+
+        const sectionEntry* _entry;
+        IniNamePool* _names;
+    };
+
+    struct KeyMatch
+    {
+        SectionRef _section;
+        KeyValue _key;
+    };
+
+    // Sections, keys, written text, the file buffer, cached values and name indexes are allocated from
+    // resource, which must outlive the IniFile. A threaded load() and concurrent read<T> with the cache
+    // enabled allocate from several threads at once and need a synchronized resource
+    explicit IniFile(std::string path, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // A copy shares the text of other and allocates from its resource. pmr containers never change
+    // their resource, so assignment rebuilds the file on the resource of other
+    IniFile(const IniFile& other);
+    IniFile(IniFile&& other) = default;
+
+    IniFile& operator=(const IniFile& other);
+    IniFile& operator=(IniFile&& other);
+
+    std::vector<IniSection> operator[](const IniSection& name) const;
+
+    // threadCount 0 uses every core. Files below 1 MiB are parsed on one thread, each further MiB allows one more
+    void load(LoadMode mode = LoadMode::Buffered, unsigned threadCount = 1);
+
+    // Re-reads the file and rebuilds only the sections whose text changed since the last load.
+    // A Mapped file sees in-place writes at once and faults when truncated, so replace it by rename;
+    // its sections are compared by hash and every key of a changed section is reported
+    IniDiff reload();
+
+    // A Mapped file is written next to its path and renamed over it, so the loaded text stays valid
 	void save() const;
 
+    // Writes only what changed since the last save: values are overwritten in place and padded with spaces,
+    // the file is rewritten from the first longer value or new key on. Comments and layout are kept.
+    // Falls back to save() without file text, that is before load(), after save() or with a name pool
+    void saveChanges();
+
+    // Same as load(), reload() and save() on executor or a new thread, errors are rethrown by get().
+    // The file must not be used until the future is ready, saveAsync() still allows reads
+    std::future<void> loadAsync(LoadMode mode = LoadMode::Buffered, unsigned threadCount = 1, IniExecutor executor = {});
+    std::future<IniDiff> reloadAsync(IniExecutor executor = {});
+    std::future<void> saveAsync(IniExecutor executor = {}) const;
+
+    FrozenIniFile freeze() const;
+
 	template<typename T>
-	T read(const IniSection& section, const std::string& key, T defaultValue = T{});
+	T read(const IniSection& section, std::string_view key, T defaultValue = T{}) const;
+
+    template<typename T, typename S, sectionName<S> = 0>
+    T read(const S& section, std::string_view key, T defaultValue = T{}) const;
+
+    // Fills the bound members of out, the section is looked up once for all fields
+    template<typename Owner, typename... T>
+    void readFields(const IniSection& section, Owner& out, const IniField<Owner, T>&... fields) const;
+
+    template<typename S, typename Owner, typename... T, sectionName<S> = 0>
+    void readFields(const S& section, Owner& out, const IniField<Owner, T>&... fields) const;
 
     IniSection writeSection(const std::string& section);
 
 	template<typename T>
-	void writeKeyValue(const IniSection& section, const std::string& key, T value);
+	void writeKeyValue(const IniSection& section, std::string_view key, T value);
+
+    bool sectionExists(const IniSection& section) const;
+    bool keyExists(const IniSection& section, std::string_view key) const;
+
+    // Remembers the parsed result of read<T> per value and type until the key is rewritten
+    void enableCache(bool enabled = true);
+
+    // Reports loads, saves, lookups and errors when built with INIFILE_STATS, nullptr turns it off
+    void setStatsSink(std::shared_ptr<IniStatsSink> sink);
 
-    bool sectionExists(const IniSection& section);
-    bool keyExists(const IniSection& section, const std::string& key);
+    // From the next load() names are interned in pool and values copied, so the file text is released;
+    // files sharing a pool store every distinct name once. nullptr keeps views into the file text
+    void setNamePool(std::shared_ptr<IniNamePool> pool);
 
-    std::vector<IniSection> sections();
-    std::vector<IniSection> sectionRange(const IniSection& section);
+    template<typename S, sectionName<S> = 0>
+    bool keyExists(const S& section, std::string_view key) const;
+
+    std::vector<IniSection> sections() const;
+    std::vector<IniSection> sectionRange(const IniSection& section) const;
     size_t sectionCount(const IniSection& section) const;
 
-    std::vector<std::string> keys(const IniSection& section);
-    size_t getKeyLineNum(const IniSection& section, const std::string& key);
+    std::vector<std::string> keys(const IniSection& section) const;
+    size_t getKeyLineNum(const IniSection& section, std::string_view key) const;
+
+    template<typename S, sectionName<S> = 0>
+    std::vector<std::string> keys(const S& section) const;
+
+    template<typename S, sectionName<S> = 0>
+    size_t getKeyLineNum(const S& section, std::string_view key) const;
+
+    SectionView sectionsView() const;
+    RangeView sectionRangeView(const IniSection& section) const;
+    KeyView keysView(const IniSection& section) const;
+
+    template<typename S, sectionName<S> = 0>
+    KeyView keysView(const S& section) const;
+
+    // Names matching a glob with '*' and '?', sorted by name and then file order. The first query builds
+    // a sorted index that any change drops, a literal prefix such as "upstream.*" is found by binary search
+    SectionMatchView sectionsMatching(std::string_view pattern) const;
+    KeyMatchView keysMatching(std::string_view pattern) const;
 
 private:
+    struct toKeyValue
+    {
+        KeyValue operator()(const keyMap::value_type& pair) const;
+    };
+
+    struct toSection
+    {
+        IniNamePool* _names;
+
+        SectionRef operator()(const sectionEntry& entry) const;
+    };
+
+    struct toDuplicate
+    {
+        const sectionEntry* _data;
+        IniNamePool* _names;
+
+        SectionRef operator()(size_t pos) const;
+    };
+
+    struct toSectionMatch
+    {
+        const sectionEntry* _data;
+        IniNamePool* _names;
+
+        SectionRef operator()(const IniNameIndex::entry& item) const;
+    };
+
+    struct toKeyMatch
+    {
+        const sectionEntry* _data;
+        IniNamePool* _names;
+
+        KeyMatch operator()(const IniNameIndex::entry& item) const;
+    };
+
     std::string _path;
-    std::unordered_multimap<element, std::unordered_map<element, std::string, elementHash>, elementHash> _data;
+    std::pmr::memory_resource* _resource;
+
+    std::pmr::vector<sectionEntry> _data;
+    std::pmr::unordered_map<element, std::pmr::vector<size_t>, elementHash> _sectionIndex;
+
+    IniArena _arena;
+
+    // Describe the file as saveChanges() left it, save() drops the text for another full save
+    mutable std::shared_ptr<const IniBuffer> _source;
+    mutable std::pmr::vector<patch> _patches;
+    mutable std::pmr::vector<size_t> _appended;
+    mutable std::optional<fileStamp> _stamp;
+
+    LoadMode _mode = LoadMode::Buffered;
+    bool _mapped = false;
+    bool _cacheEnabled = false;
+    IniNameIndex _sectionNames;
+    IniNameIndex _keyNames;
+    std::shared_ptr<IniStatsSink> _stats;
+    std::shared_ptr<IniNamePool> _names;
+
+    // Names of the IniSection handles returned without a pool of their own, shared by copies
+    std::shared_ptr<IniNamePool> _handleNames = std::make_shared<IniNamePool>();
+
+    static void addKeyValue(sectionEntry* entry, std::string_view key, std::string_view value, size_t lineNum);
+    static size_t parseChunk(std::string_view text, size_t lineNum, std::pmr::vector<sectionEntry>& data);
+    static size_t nextSectionStart(std::string_view text, size_t pos);
+    static void parseKeys(sectionEntry& entry);
+    static void rebase(keyMap& keys, const sectionEntry& from, const sectionEntry& to);
+    static fileStamp stampOf(const std::string& path);
+
+    struct sourceInfo
+    {
+        size_t _bytes;
+        size_t _lines;
+    };
+
+    sourceInfo loadSource(LoadMode mode, unsigned threadCount);
+    sourceInfo reloadSource(IniDiff& diff);
+    size_t saveText() const;
+    size_t patchText();
+
+    template<typename F>
+    auto measured(F&& body) const;
 
-    using dataIterator = std::unordered_multimap<element, std::unordered_map<element, std::string, elementHash>, elementHash>::iterator;
+    template<typename F>
+    static std::future<std::invoke_result_t<F>> runAsync(const IniExecutor& executor, F body);
 
-    static std::string readWord(const std::string& line);
+    void rebuildIndex();
+    void dropNameIndex();
+    void adoptSource(const std::shared_ptr<const IniBuffer>& buffer, LoadMode mode, const fileStamp& stamp);
+    void internSource(IniArena& arena);
+    void fingerprintSource(IniArena& arena);
+    bool unchanged(const sectionEntry& old, const sectionEntry& entry) const;
+    std::string_view storeName(std::string_view name);
 
-    dataIterator getIterator(const IniSection& section);
-    size_t getIteratorIndex(dataIterator it);
+    IniNamePool* handleNames() const;
+    IniSection handle(std::string_view name, size_t index, size_t lineNum) const;
+    bool inSource(std::string_view text) const;
+    size_t offsetOf(std::string_view text) const;
 
-    std::string addLineNum(dataIterator it, const std::string& key, const std::string& message);
+    template<typename T>
+    T readValue(std::string_view section, constDataIterator it, std::string_view key, T defaultValue) const;
+
+    template<typename T>
+    T parseValue(constDataIterator it, std::string_view key, std::string_view text) const;
+
+    void writeValue(dataIterator it, std::string_view key, std::string_view value);
+
+    bool keyExists(constDataIterator it, std::string_view key) const;
+    std::vector<std::string> keys(constDataIterator it) const;
+    size_t getKeyLineNum(constDataIterator it, std::string_view key) const;
+
+    dataIterator insertSection(std::string_view name, size_t lineNum);
+    dataIterator getIterator(std::string_view name, size_t index);
+    constDataIterator getIterator(std::string_view name, size_t index) const;
+
+    std::string addLineNum(constDataIterator it, std::string_view key, const std::string& message) const;
 };
 
 
+template<>
+void IniFile::writeKeyValue(const IniSection& section, std::string_view key, bool value);
+
+template<>
+void IniFile::writeKeyValue(const IniSection& section, std::string_view key, const std::string& value);
+
+
 template<typename T>
-T IniFile::read(const IniSection& section, const std::string& key, T defaultValue)
+T IniFile::read(const IniSection& section, std::string_view key, T defaultValue) const
+{
+    return readValue(section.getName(), getIterator( section.getName(), section.getIndex() ), key, std::move(defaultValue));
+}
+
+template<typename T, typename S, IniFile::sectionName<S>>
+T IniFile::read(const S& section, std::string_view key, T defaultValue) const
+{
+    return readValue(section, getIterator(section, 0), key, std::move(defaultValue));
+}
+
+template<typename Owner, typename... T>
+void IniFile::readFields(const IniSection& section, Owner& out, const IniField<Owner, T>&... fields) const
+{
+    auto it = getIterator( section.getName(), section.getIndex() );
+    ( (out.*fields._member = readValue(section.getName(), it, fields._key, fields._defaultValue)), ... );
+}
+
+template<typename S, typename Owner, typename... T, IniFile::sectionName<S>>
+void IniFile::readFields(const S& section, Owner& out, const IniField<Owner, T>&... fields) const
 {
-    auto pairIt = getIterator(section);
+    auto it = getIterator(section, 0);
+    ( (out.*fields._member = readValue(section, it, fields._key, fields._defaultValue)), ... );
+}
 
-    if (pairIt == _data.end() || pairIt->second.find(key) == pairIt->second.end())
+template<typename S, IniFile::sectionName<S>>
+IniFile::KeyView IniFile::keysView(const S& section) const
+{
+    auto it = getIterator(section, 0);
+
+    if (it == _data.end())
     {
+        return {{}, {}};
+    }
+
+    return {it->_keys.begin(), it->_keys.end()};
+}
+
+template<typename S, IniFile::sectionName<S>>
+bool IniFile::keyExists(const S& section, std::string_view key) const
+{
+    return keyExists(getIterator(section, 0), key);
+}
+
+template<typename S, IniFile::sectionName<S>>
+std::vector<std::string> IniFile::keys(const S& section) const
+{
+    return keys( getIterator(section, 0) );
+}
+
+template<typename S, IniFile::sectionName<S>>
+size_t IniFile::getKeyLineNum(const S& section, std::string_view key) const
+{
+    return getKeyLineNum(getIterator(section, 0), key);
+}
+
+template<typename T>
+T IniFile::readValue([[maybe_unused]] std::string_view section, constDataIterator it, std::string_view key, T defaultValue) const
+{
+    if (it == _data.end())
+    {
+        INIFILE_STAT(_stats, onLookup(section, key, false, false));
         return defaultValue;
     }
 
-    const std::string& line = pairIt->second.find(key)->second;
+    auto keyIt = it->_keys.find(key);
+    INIFILE_STAT(_stats, onLookup(section, key, true, keyIt != it->_keys.end()));
 
-    if (std::is_integral<T>() || std::is_floating_point<T>())
+    if (keyIt == it->_keys.end())
     {
-        size_t dotCount = 0;
+        return defaultValue;
+    }
 
-        for (auto it = line.begin(); it != line.end(); ++it)
+    if constexpr ( std::is_same_v<T, std::string> )
+    {
+        return std::string(keyIt->second);
+    }
+    else
+    {
+        T value{};
+        size_t pos = keyIt - it->_keys.begin();
+
+        if ( _cacheEnabled && it->_cache.find(pos, value) )
         {
-            if (*it == parser::minus)
-            {
-                if (it != line.begin())
-                {
-                    throw std::runtime_error( addLineNum(pairIt, key, "wrong '-' position") );
-                }
-            }
-            else if (*it == parser::numSeparator)
-            {
-                ++dotCount;
-            }
-            else if ( !std::isdigit(*it) )
-            {
-                throw std::runtime_error( addLineNum(pairIt, key, "not digit character in digit value") );
-            }
+            return value;
         }
 
-        if (dotCount > 1)
+        value = parseValue<T>(it, key, keyIt->second);
+
+        if (_cacheEnabled)
         {
-            throw std::runtime_error(addLineNum(pairIt, key, "incorrect number of dots"));
+            it->_cache.insert(pos, it->_keys.size(), value, _resource);
         }
+
+        return value;
     }
+}
 
-    if ( std::is_unsigned<T>() )
+template<typename T>
+T IniFile::parseValue(constDataIterator it, std::string_view key, std::string_view text) const
+{
+    T value{};
+    const char* error = parser::parseValue(text, value);
+
+    if (error != nullptr)
     {
-        if (line.find('-') != std::string::npos)
-        {
-            throw std::runtime_error( addLineNum(pairIt, key, "minus in unsigned value") );
-        }
+        std::string message = addLineNum(it, key, error);
+        INIFILE_STAT(_stats, onError(_path, message));
+
+        throw std::runtime_error(message);
     }
 
-    T value;
+    return value;
+}
 
-    std::istringstream stream(pairIt->second[key] );
-    stream >> value;
+template<typename F>
+auto IniFile::measured(F&& body) const
+{
+    auto start = std::chrono::steady_clock::now();
 
-    return value;
+    try
+    {
+        auto result = body();
+        return std::make_pair(result, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start));
+    }
+    catch (const std::exception& error)
+    {
+        _stats->onError(_path, error.what());
+        throw;
+    }
+}
+
+template<typename F>
+std::future<std::invoke_result_t<F>> IniFile::runAsync(const IniExecutor& executor, F body)
+{
+    if ( !executor )
+    {
+        return std::async(std::launch::async, std::move(body));
+    }
+
+    // std::function needs a copyable task, so the promise is shared
+    auto promise = std::make_shared<std::promise<std::invoke_result_t<F>>>();
+    auto future = promise->get_future();
+
+    executor([promise, body = std::move(body)]() {
+        try
+        {
+            if constexpr (std::is_void_v<std::invoke_result_t<F>>)
+            {
+                body();
+                promise->set_value();
+            }
+            else
+            {
+                promise->set_value( body() );
+            }
+        }
+        catch (...)
+        {
+            promise->set_exception( std::current_exception() );
+        }
+    });
+
+    return future;
 }
 
 template<typename T>
-void IniFile::writeKeyValue(const IniSection& section, const std::string& key, T value)
+void IniFile::writeKeyValue(const IniSection& section, std::string_view key, T value)
 {
-    auto it = getIterator(section);
+    auto it = getIterator( section.getName(), section.getIndex() );
 
     if (it == _data.end())
     {
         return;
     }
 
-    it->second[key] << std::to_string(value);
+    if constexpr ( std::is_same_v<T, char> )
+    {
+        writeValue(it, key, std::string_view(&value, 1));
+    }
+    else
+    {
+        char buffer[parser::formatLength<T>];
+        writeValue(it, key, std::string_view( buffer, parser::formatNumber(value, buffer) ));
+    }
 }
 
 
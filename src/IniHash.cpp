@@ -0,0 +1,25 @@
+#include "IniHash.h"
+
+#include <chrono>
+#include <random>
+
+namespace
+{
+    std::uint64_t draw(std::random_device& device, std::uint64_t salt)
+    {
+        std::uint64_t value = (std::uint64_t(device()) << 32) ^ device() ^ salt;
+        value = parser::multiplyFold(value ^ 0x9E3779B97F4A7C15ull, 0xBF58476D1CE4E5B9ull);
+
+        return value | 1;
+    }
+}
+
+// The clock and the address differ between processes even where the random device is deterministic
+parser::hashSecret parser::drawHashSecret()
+{
+    std::random_device device;
+    auto salt = static_cast<std::uint64_t>( std::chrono::steady_clock::now().time_since_epoch().count() ) ^
+                static_cast<std::uint64_t>( reinterpret_cast<std::uintptr_t>(&device) );
+
+    return {draw(device, salt), draw(device, salt * 3), draw(device, salt * 5)};
+}
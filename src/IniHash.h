@@ -0,0 +1,118 @@
+#ifndef INIHASH_H
+#define INIHASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+    #include <intrin.h>
+#endif
+
+
+namespace parser
+{
+    struct hashSecret
+    {
+        std::uint64_t _seed;
+        std::uint64_t _word;
+        std::uint64_t _length;
+    };
+
+    // Drawn once per process from the random device, the clock and an address
+    hashSecret drawHashSecret();
+
+    inline const hashSecret& processHashSecret()
+    {
+        static const hashSecret secret = drawHashSecret();
+        return secret;
+    }
+
+    // The 128-bit product folded to 64 bits, it mixes both operands so no difference in one of them
+    // cancels without knowing the other
+    inline std::uint64_t multiplyFold(std::uint64_t left, std::uint64_t right)
+    {
+#if defined(_MSC_VER) && defined(_M_X64)
+        std::uint64_t high;
+        std::uint64_t low = _umul128(left, right, &high);
+
+        return low ^ high;
+#elif defined(__SIZEOF_INT128__)
+        unsigned __int128 product = static_cast<unsigned __int128>(left) * right;
+
+        return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+#else
+        std::uint64_t leftHigh = left >> 32, leftLow = left & 0xffffffff;
+        std::uint64_t rightHigh = right >> 32, rightLow = right & 0xffffffff;
+
+        std::uint64_t lowLow = leftLow * rightLow;
+        std::uint64_t highLow = leftHigh * rightLow;
+        std::uint64_t lowHigh = leftLow * rightHigh;
+        std::uint64_t middle = (lowLow >> 32) + (highLow & 0xffffffff) + (lowHigh & 0xffffffff);
+
+        std::uint64_t low = (lowLow & 0xffffffff) | (middle << 32);
+        std::uint64_t high = leftHigh * rightHigh + (highLow >> 32) + (lowHigh >> 32) + (middle >> 32);
+
+        return low ^ high;
+#endif
+    }
+
+    template<typename T>
+    std::uint64_t loadWord(const char* data)
+    {
+        T value;
+        std::memcpy(&value, data, sizeof(T));
+
+        return value;
+    }
+
+    // Hash of a name keyed with a secret drawn once per process. std::hash of libstdc++ has
+    // collisions that hold for every seed, so names from a file could otherwise share one bucket.
+    // The last word overlaps the one before it, the length keeps such names apart
+    inline std::size_t seededHash(std::string_view name) noexcept
+    {
+        const hashSecret& secret = processHashSecret();
+
+        const char* data = name.data();
+        size_t size = name.size();
+        std::uint64_t hash = secret._seed ^ size;
+        std::uint64_t last;
+
+        if (size >= 8)
+        {
+            for (size_t pos = 0; pos + 8 < size; pos += 8)
+            {
+                hash = multiplyFold(loadWord<std::uint64_t>(data + pos) ^ secret._word, hash ^ secret._length);
+            }
+
+            last = loadWord<std::uint64_t>(data + size - 8);
+        }
+        else if (size >= 4)
+        {
+            last = (loadWord<std::uint32_t>(data) << 32) | loadWord<std::uint32_t>(data + size - 4);
+        }
+        else if (size > 0)
+        {
+            last = (std::uint64_t(static_cast<unsigned char>(data[0])) << 16) |
+                   (std::uint64_t(static_cast<unsigned char>(data[size / 2])) << 8) | static_cast<unsigned char>(data[size - 1]);
+        }
+        else
+        {
+            last = 0;
+        }
+
+        return static_cast<std::size_t>( multiplyFold(last ^ secret._word, hash ^ secret._length) );
+    }
+
+    struct seededHasher
+    {
+        std::size_t operator()(std::string_view name) const noexcept
+        {
+            return seededHash(name);
+        }
+    };
+}
+
+
+#endif //INIHASH_H
@@ -0,0 +1,123 @@
+#include "IniNameIndex.h"
+
+#include <algorithm>
+
+IniNameIndex::iterator::iterator(base it, base end, std::shared_ptr<const std::string> pattern)
+        : _it(it), _end(end), _pattern( std::move(pattern) )
+{
+    skip();
+}
+
+const IniNameIndex::entry& IniNameIndex::iterator::operator*() const
+{
+    return *_it;
+}
+
+IniNameIndex::iterator& IniNameIndex::iterator::operator++()
+{
+    ++_it;
+    skip();
+
+    return *this;
+}
+
+IniNameIndex::iterator IniNameIndex::iterator::operator++(int)
+{
+    iterator copy = *this;
+    ++*this;
+
+    return copy;
+}
+
+bool IniNameIndex::iterator::operator==(const iterator& other) const
+{
+    return _it == other._it;
+}
+
+bool IniNameIndex::iterator::operator!=(const iterator& other) const
+{
+    return _it != other._it;
+}
+
+void IniNameIndex::iterator::skip()
+{
+    while (_it != _end && !matches(*_pattern, _it->_name))
+    {
+        ++_it;
+    }
+}
+
+IniNameIndex::IniNameIndex(std::pmr::memory_resource* resource) : _entries(resource)
+{}
+
+IniNameIndex::IniNameIndex(const IniNameIndex& other) : _entries( other._entries.get_allocator() )
+{}
+
+IniNameIndex& IniNameIndex::operator=(const IniNameIndex& other)
+{
+    if (this != &other)
+    {
+        clear();
+    }
+
+    return *this;
+}
+
+void IniNameIndex::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _entries.clear();
+    _built.store(false, std::memory_order_release);
+}
+
+bool IniNameIndex::matches(std::string_view pattern, std::string_view name)
+{
+    size_t patternPos = 0;
+    size_t namePos = 0;
+    size_t starPos = std::string_view::npos;
+    size_t resumePos = 0;
+
+    // Backtracks only to the last '*', so the worst case is pattern size times name size
+    while (namePos < name.size())
+    {
+        if (patternPos < pattern.size() && (pattern[patternPos] == '?' || pattern[patternPos] == name[namePos]))
+        {
+            ++patternPos;
+            ++namePos;
+        }
+        else if (patternPos < pattern.size() && pattern[patternPos] == '*')
+        {
+            starPos = patternPos++;
+            resumePos = namePos;
+        }
+        else if (starPos != std::string_view::npos)
+        {
+            patternPos = starPos + 1;
+            namePos = ++resumePos;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    while (patternPos < pattern.size() && pattern[patternPos] == '*')
+    {
+        ++patternPos;
+    }
+
+    return patternPos == pattern.size();
+}
+
+void IniNameIndex::sort() const
+{
+    std::sort(_entries.begin(), _entries.end(), [](const entry& left, const entry& right) {
+        if (left._name != right._name)
+        {
+            return left._name < right._name;
+        }
+
+        return left._section != right._section ? left._section < right._section : left._key < right._key;
+    });
+}
@@ -0,0 +1,116 @@
+#ifndef ININAMEINDEX_H
+#define ININAMEINDEX_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+// Names sorted once on the first query, so a glob with a literal prefix only visits the names
+// sharing that prefix. Like IniCache a copy starts empty and builds its own
+class IniNameIndex
+{
+public:
+    struct entry
+    {
+        std::string_view _name;
+        size_t _section;
+        size_t _key;
+    };
+
+    // Skips the entries of the prefix range that don't match the whole pattern. Iterators share
+    // a copy of the pattern, so views over them don't depend on the caller's string
+    class iterator
+    {
+    public:
+        using base = std::pmr::vector<entry>::const_iterator;
+
+        using iterator_category = std::input_iterator_tag;
+        using value_type = entry;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const entry*;
+        using reference = const entry&;
+
+        iterator() = default;
+        iterator(base it, base end, std::shared_ptr<const std::string> pattern);
+
+        const entry& operator*() const;
+
+        iterator& operator++();
+        iterator operator++(int);
+
+        bool operator==(const iterator& other) const;
+        bool operator!=(const iterator& other) const;
+
+    private:
+        base _it;
+        base _end;
+        std::shared_ptr<const std::string> _pattern;
+
+        void skip();
+    };
+
+    explicit IniNameIndex(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // Starts empty on the resource of other
+    IniNameIndex(const IniNameIndex& other);
+    IniNameIndex& operator=(const IniNameIndex& other);
+
+    // fill receives the empty entry vector the first time, later calls reuse the sorted result
+    template<typename Fill>
+    std::pair<iterator, iterator> match(std::string_view pattern, Fill&& fill) const;
+
+    void clear();
+
+    // '*' matches any run of characters and '?' a single one
+    static bool matches(std::string_view pattern, std::string_view name);
+
+private:
+    mutable std::atomic<bool> _built{false};
+    mutable std::mutex _mutex;
+    mutable std::pmr::vector<entry> _entries;
+
+    void sort() const;
+};
+
+
+template<typename Fill>
+std::pair<IniNameIndex::iterator, IniNameIndex::iterator> IniNameIndex::match(std::string_view pattern, Fill&& fill) const
+{
+    if ( !_built.load(std::memory_order_acquire) )
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if ( !_built.load(std::memory_order_relaxed) )
+        {
+            fill(_entries);
+            sort();
+            _built.store(true, std::memory_order_release);
+        }
+    }
+
+    auto prefix = pattern.substr( 0, pattern.find_first_of("*?") );
+
+    auto first = std::partition_point(_entries.cbegin(), _entries.cend(), [prefix](const entry& item) {
+        return item._name < prefix;
+    });
+
+    auto last = std::partition_point(first, _entries.cend(), [prefix](const entry& item) {
+        return item._name.substr(0, prefix.size()) == prefix;
+    });
+
+    auto owned = std::make_shared<const std::string>(pattern);
+
+    return {iterator(first, last, owned), iterator(last, last, owned)};
+}
+
+
+#endif //ININAMEINDEX_H
@@ -0,0 +1,35 @@
+#include "IniNamePool.h"
+
+#include <mutex>
+
+const std::string* IniNamePool::intern(std::string_view name)
+{
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        auto it = _index.find(name);
+
+        if (it != _index.end())
+        {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    auto it = _index.find(name);
+
+    if (it != _index.end())
+    {
+        return it->second;
+    }
+
+    const std::string* stored = &_names.emplace_back(name);
+    _index.emplace(*stored, stored);
+
+    return stored;
+}
+
+size_t IniNamePool::size() const
+{
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+    return _names.size();
+}
@@ -0,0 +1,33 @@
+#ifndef ININAMEPOOL_H
+#define ININAMEPOOL_H
+
+#include "IniHash.h"
+
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+
+// Thread-safe set of names, every distinct name is stored once and keeps its address for the
+// lifetime of the pool, so interned names compare and hash by pointer
+class IniNamePool
+{
+public:
+    IniNamePool() = default;
+
+    IniNamePool(const IniNamePool& other) = delete;
+    IniNamePool& operator=(const IniNamePool& other) = delete;
+
+    const std::string* intern(std::string_view name);
+    size_t size() const;
+
+private:
+    mutable std::shared_mutex _mutex;
+    std::deque<std::string> _names;
+    std::unordered_map<std::string_view, const std::string*, parser::seededHasher> _index;
+};
+
+
+#endif //ININAMEPOOL_H
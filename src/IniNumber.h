@@ -0,0 +1,168 @@
+#ifndef ININUMBER_H
+#define ININUMBER_H
+
+#include <algorithm>
+#include <charconv>
+#include <limits>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#if !defined(__cpp_lib_to_chars)
+    #include <iomanip>
+    #include <locale>
+    #include <sstream>
+    #include <string>
+#endif
+
+
+namespace parser
+{
+    constexpr auto numSeparator = '.';
+    constexpr auto minus = '-';
+
+    // Returns nullptr on success, otherwise the reason why text isn't a T.
+    // Integral types keep the old behaviour of dropping the fractional part.
+    template<typename T>
+    const char* parseNumber(std::string_view text, T& value)
+    {
+        static_assert(std::is_integral_v<T> || std::is_floating_point_v<T>, "parseNumber needs a numeric type");
+
+        if ( text.empty() )
+        {
+            return "empty digit value";
+        }
+
+        if constexpr ( std::is_floating_point_v<T> )
+        {
+            // formatNumber writes non-finite values this way
+            std::string_view word = text.substr(text.front() == minus ? 1 : 0);
+
+            if (word == "inf" || word == "nan")
+            {
+                value = word == "inf" ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::quiet_NaN();
+                value = text.front() == minus ? -value : value;
+
+                return nullptr;
+            }
+        }
+
+        size_t dotCount = 0;
+        size_t dotPos = text.size();
+
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            if (text[i] == minus)
+            {
+                if (i != 0)
+                {
+                    return "wrong '-' position";
+                }
+            }
+            else if (text[i] == numSeparator)
+            {
+                if (dotCount == 0)
+                {
+                    dotPos = i;
+                }
+
+                ++dotCount;
+            }
+            else if (text[i] < '0' || text[i] > '9')
+            {
+                return "not digit character in digit value";
+            }
+        }
+
+        if (dotCount > 1)
+        {
+            return "incorrect number of dots";
+        }
+
+        if constexpr ( std::is_unsigned_v<T> )
+        {
+            if (text.front() == minus)
+            {
+                return "minus in unsigned value";
+            }
+        }
+
+        const char* first = text.data();
+        const char* last = text.data() + text.size();
+        std::from_chars_result result{};
+
+        if constexpr ( std::is_integral_v<T> )
+        {
+            last = text.data() + dotPos;
+            result = std::from_chars(first, last, value);
+        }
+        else
+        {
+#if defined(__cpp_lib_to_chars)
+            result = std::from_chars(first, last, value, std::chars_format::fixed);
+#else
+            std::istringstream stream{ std::string(text) };
+            stream.imbue( std::locale::classic() );
+
+            if ( !(stream >> value) )
+            {
+                return "value out of range";
+            }
+
+            result.ptr = last;
+#endif
+        }
+
+        if (result.ec == std::errc::result_out_of_range)
+        {
+            return "value out of range";
+        }
+
+        if (result.ec != std::errc() || result.ptr != last)
+        {
+            return "not digit character in digit value";
+        }
+
+        return nullptr;
+    }
+
+    // Room for formatNumber, fixed notation spells out every digit of the largest and the smallest T
+    template<typename T>
+    constexpr size_t formatLength = std::is_integral_v<T>
+            ? std::numeric_limits<T>::digits10 + 3
+            : std::max(std::numeric_limits<T>::max_exponent10, -std::numeric_limits<T>::min_exponent10 + std::numeric_limits<T>::max_digits10)
+              + std::numeric_limits<T>::max_digits10 + 4;
+
+    // Writes value into buffer of formatLength<T> chars and returns the length. Independent of
+    // the locale, floating point values get the shortest fixed text that parseNumber reads back exactly,
+    // or "inf", "-inf" and "nan"
+    template<typename T>
+    size_t formatNumber(T value, char* buffer)
+    {
+        static_assert(std::is_integral_v<T> || std::is_floating_point_v<T>, "formatNumber needs a numeric type");
+
+        if constexpr ( std::is_integral_v<T> )
+        {
+            return std::to_chars(buffer, buffer + formatLength<T>, value).ptr - buffer;
+        }
+        else
+        {
+#if defined(__cpp_lib_to_chars)
+            return std::to_chars(buffer, buffer + formatLength<T>, value, std::chars_format::fixed).ptr - buffer;
+#else
+            std::ostringstream stream;
+            stream.imbue( std::locale::classic() );
+            stream << std::fixed << std::setprecision(std::numeric_limits<T>::max_digits10) << value;
+
+            std::string text = stream.str();
+            size_t length = std::min(text.size(), formatLength<T>);
+            std::copy_n(text.data(), length, buffer);
+
+            return length;
+#endif
+        }
+    }
+}
+
+
+#endif //ININUMBER_H
@@ -0,0 +1,210 @@
+#include "IniParser.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+    std::string_view trimSpaces(std::string_view line)
+    {
+        size_t startPos = line.find_first_not_of(' ');
+
+        if (startPos == std::string_view::npos)
+        {
+            return {};
+        }
+
+        return line.substr(startPos, line.find_last_not_of(' ') - startPos + 1);
+    }
+}
+
+std::string_view parser::nextLine(std::string_view& text)
+{
+    size_t lineEnd = text.find('\n');
+    std::string_view line = text.substr(0, lineEnd);
+    text.remove_prefix(lineEnd == std::string_view::npos ? text.size() : lineEnd + 1);
+
+    return line;
+}
+
+parser::lineType parser::parseLine(std::string_view line, std::string_view& first, std::string_view& second)
+{
+    return parseLine(line, scanLine(line), first, second);
+}
+
+parser::lineType parser::parseLine(std::string_view line, const lineMarks& marks, std::string_view& first,
+                                   std::string_view& second)
+{
+    size_t firstPos = line.find_first_not_of(' ');
+
+    if (firstPos == std::string_view::npos)
+    {
+        return lineType::blank;
+    }
+
+    if (firstPos == marks._comment)
+    {
+        first = line.substr(firstPos + 1);
+        return lineType::comment;
+    }
+
+    if (marks._leftBracket != std::string_view::npos && marks._rightBracket != std::string_view::npos &&
+        marks._leftBracket < marks._rightBracket)
+    {
+        first = line.substr(marks._leftBracket + 1, marks._rightBracket - marks._leftBracket - 1);
+        return lineType::section;
+    }
+
+    if (marks._equal == std::string_view::npos)
+    {
+        return lineType::text;
+    }
+
+    size_t valueEnd = marks._comment > marks._equal ? marks._comment : line.find(commentStart, marks._equal + 1);
+
+    first = trimSpaces( line.substr(0, std::min(marks._comment, marks._equal)) );
+    second = trimSpaces( line.substr(marks._equal + 1, valueEnd - marks._equal - 1) );
+
+    return lineType::keyValue;
+}
+
+parser::lineType parser::readLine(std::string_view& text, std::string_view& first, std::string_view& second)
+{
+    lineMarks marks = scanLine(text);
+    std::string_view line = text.substr(0, marks._length);
+
+    text.remove_prefix(marks._length == text.size() ? text.size() : marks._length + 1);
+
+    return parseLine(line, marks, first, second);
+}
+
+bool IniHandler::onSection(std::string_view, size_t)
+{
+    return true;
+}
+
+bool IniHandler::onKeyValue(std::string_view, std::string_view, size_t)
+{
+    return true;
+}
+
+bool IniHandler::onComment(std::string_view, size_t)
+{
+    return true;
+}
+
+bool IniHandler::onError(const std::string& message, size_t lineNum)
+{
+    throw std::runtime_error(message + " in line: " + std::to_string(lineNum));
+}
+
+IniParser::IniParser(std::string path, size_t chunkSize) : _path( std::move(path) ), _chunkSize(chunkSize)
+{
+    if (_chunkSize == 0)
+    {
+        throw std::runtime_error("chunk size can't be zero");
+    }
+}
+
+bool IniParser::parse(IniHandler& handler) const
+{
+    std::ifstream file(_path, std::ios::binary);
+
+    if ( !file.is_open() )
+    {
+        throw std::runtime_error("can't open IniFile: " + _path);
+    }
+
+    std::string buffer;
+    position pos;
+    bool more = true;
+
+    while (more)
+    {
+        size_t kept = buffer.size();
+        buffer.resize(kept + _chunkSize);
+
+        file.read(buffer.data() + kept, static_cast<std::streamsize>(_chunkSize));
+        buffer.resize( kept + static_cast<size_t>( file.gcount() ) );
+
+        if ( file.bad() )
+        {
+            throw std::runtime_error("can't read IniFile: " + _path);
+        }
+
+        more = static_cast<bool>(file);
+        std::string_view text = buffer;
+
+        // Only whole lines are parsed, the tail waits for the next chunk. The kept tail has no
+        // newline, so only the new bytes are searched and a long line isn't scanned once per chunk
+        if (more)
+        {
+            size_t lastLineEnd = text.substr(kept).rfind('\n');
+            text = text.substr(0, lastLineEnd == std::string_view::npos ? 0 : kept + lastLineEnd + 1);
+        }
+
+        if ( !parseLines(text, handler, pos) )
+        {
+            return false;
+        }
+
+        buffer.erase(0, text.size());
+    }
+
+    return true;
+}
+
+bool IniParser::parse(std::string_view text, IniHandler& handler)
+{
+    position pos;
+    return parseLines(text, handler, pos);
+}
+
+bool IniParser::parseLines(std::string_view text, IniHandler& handler, position& pos)
+{
+    std::string_view first;
+    std::string_view second;
+
+    for (; !text.empty(); ++pos._lineNum)
+    {
+        bool proceed = true;
+
+        switch ( parser::readLine(text, first, second) )
+        {
+            case parser::lineType::comment:
+                proceed = handler.onComment(first, pos._lineNum);
+                break;
+
+            case parser::lineType::section:
+                pos._inSection = true;
+                proceed = handler.onSection(first, pos._lineNum);
+                break;
+
+            case parser::lineType::keyValue:
+                if (first.empty() || second.empty())
+                {
+                    proceed = handler.onError("empty key or value", pos._lineNum);
+                }
+                else if ( !pos._inSection )
+                {
+                    proceed = handler.onError("key and value without section", pos._lineNum);
+                }
+                else
+                {
+                    proceed = handler.onKeyValue(first, second, pos._lineNum);
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        if ( !proceed )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
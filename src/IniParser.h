@@ -0,0 +1,73 @@
+#ifndef INIPARSER_H
+#define INIPARSER_H
+
+#include "IniScanner.h"
+
+#include <string>
+#include <string_view>
+
+
+namespace parser
+{
+    constexpr auto commentStart = ';';
+
+    enum class lineType
+    {
+        blank,
+        comment,
+        section,
+        keyValue,
+        text
+    };
+
+    std::string_view nextLine(std::string_view& text);
+
+    // Section sets first to the name, keyValue sets first and second, comment sets first to the text after ';'
+    lineType parseLine(std::string_view line, std::string_view& first, std::string_view& second);
+    lineType parseLine(std::string_view line, const lineMarks& marks, std::string_view& first, std::string_view& second);
+
+    // Takes the first line off text and parses it, scanning its bytes only once
+    lineType readLine(std::string_view& text, std::string_view& first, std::string_view& second);
+}
+
+
+// Callbacks of IniParser, returning false from any of them stops the parse
+class IniHandler
+{
+public:
+    virtual ~IniHandler() = default;
+
+    virtual bool onSection(std::string_view name, size_t lineNum);
+    virtual bool onKeyValue(std::string_view key, std::string_view value, size_t lineNum);
+    virtual bool onComment(std::string_view text, size_t lineNum);
+
+    // Throws the same exception IniFile::load() would, override to skip bad lines
+    virtual bool onError(const std::string& message, size_t lineNum);
+};
+
+
+// Reports the file line by line without building an IniFile, memory use is one chunk plus the longest line
+class IniParser
+{
+public:
+    explicit IniParser(std::string path, size_t chunkSize = 64 * 1024);
+
+    // Returns false when a handler stopped the parse
+    bool parse(IniHandler& handler) const;
+    static bool parse(std::string_view text, IniHandler& handler);
+
+private:
+    struct position
+    {
+        size_t _lineNum = 1;
+        bool _inSection = false;
+    };
+
+    std::string _path;
+    size_t _chunkSize;
+
+    static bool parseLines(std::string_view text, IniHandler& handler, position& pos);
+};
+
+
+#endif //INIPARSER_H
@@ -0,0 +1,148 @@
+#ifndef INIRECORD_H
+#define INIRECORD_H
+
+#include "FrozenIniFile.h"
+
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+
+// Key name with its hash computed at compile time, T is the type the value is parsed into.
+// A std::optional<T> key may be missing from the section
+template<typename T>
+struct IniKey
+{
+    using type = T;
+
+    constexpr explicit IniKey(std::string_view name) : _name(name), _hash( parser::hashName(name) )
+    {}
+
+    std::string_view _name;
+    std::uint64_t _hash;
+};
+
+
+// Typed values of one FrozenIniFile section, every key is found and parsed once in the constructor
+// so a missing key or a bad value throws there and get() is a plain member access.
+// Keys must be constexpr objects with static storage:
+//
+//     inline constexpr IniKey<int> port("port");
+//     IniRecord<port> server(frozen, "server");
+//     int value = server.get<port>();
+template<const auto&... Keys>
+class IniRecord
+{
+public:
+    IniRecord(const FrozenIniFile& file, const IniSection& section);
+
+    template<const auto& Key>
+    const auto& get() const;
+
+private:
+    template<typename T>
+    struct isOptional : std::false_type
+    {};
+
+    template<typename T>
+    struct isOptional<std::optional<T>> : std::true_type
+    {};
+
+    template<const auto& A, const auto& B>
+    struct sameKey : std::false_type
+    {};
+
+    template<const auto& A>
+    struct sameKey<A, A> : std::true_type
+    {};
+
+    std::tuple<typename std::decay_t<decltype(Keys)>::type...> _values;
+
+    template<const auto& Key>
+    static constexpr size_t indexOf();
+
+    template<typename T>
+    static void bind(const FrozenIniFile& file, std::uint32_t section, const IniKey<T>& key, T& value);
+};
+
+
+template<const auto&... Keys>
+IniRecord<Keys...>::IniRecord(const FrozenIniFile& file, const IniSection& section)
+{
+    std::uint32_t sectionNum = file.findSection( section.getName(), section.getIndex() );
+
+    if (sectionNum == FrozenIniFile::npos)
+    {
+        throw std::runtime_error("section not found: " + std::string( section.getName() ));
+    }
+
+    std::apply([&](auto&... values){
+        ( bind(file, sectionNum, Keys, values), ... );
+    }, _values);
+}
+
+template<const auto&... Keys>
+template<const auto& Key>
+const auto& IniRecord<Keys...>::get() const
+{
+    constexpr size_t index = indexOf<Key>();
+    static_assert(index < sizeof...(Keys), "key is not part of this IniRecord");
+
+    return std::get<index>(_values);
+}
+
+template<const auto&... Keys>
+template<const auto& Key>
+constexpr size_t IniRecord<Keys...>::indexOf()
+{
+    constexpr bool matches[] = { sameKey<Key, Keys>::value... };
+
+    for (size_t i = 0; i < sizeof...(Keys); ++i)
+    {
+        if (matches[i])
+        {
+            return i;
+        }
+    }
+
+    return sizeof...(Keys);
+}
+
+template<const auto&... Keys>
+template<typename T>
+void IniRecord<Keys...>::bind(const FrozenIniFile& file, std::uint32_t section, const IniKey<T>& key, T& value)
+{
+    std::uint32_t keyItem = file.findKey(section, key._name, key._hash);
+    const char* error = nullptr;
+
+    if constexpr ( isOptional<T>::value )
+    {
+        if (keyItem == FrozenIniFile::npos)
+        {
+            value.reset();
+            return;
+        }
+
+        error = parser::parseValue(file.view( file._keys[keyItem]._value ), value.emplace());
+    }
+    else
+    {
+        if (keyItem == FrozenIniFile::npos)
+        {
+            throw std::runtime_error("key not found: " + std::string(key._name));
+        }
+
+        error = parser::parseValue(file.view( file._keys[keyItem]._value ), value);
+    }
+
+    if (error != nullptr)
+    {
+        throw std::runtime_error( file.addLineNum(keyItem, error) );
+    }
+}
+
+
+#endif //INIRECORD_H
@@ -0,0 +1,205 @@
+#include "IniScanner.h"
+
+#include <cstdint>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define INIFILE_SIMD
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define INIFILE_SIMD
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+    #include <arm_neon.h>
+    #define INIFILE_SIMD
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+// Forces the scalar path, to run the tests without blocks on a target that has them
+#if defined(INIFILE_SCALAR_SCAN)
+    #undef INIFILE_SIMD
+#endif
+
+namespace
+{
+#if defined(__AVX2__)
+    constexpr size_t blockSize = 32;
+    constexpr unsigned bitsPerByte = 1;
+
+    struct block
+    {
+        explicit block(const char* data) : _data( _mm256_loadu_si256( reinterpret_cast<const __m256i*>(data) ) )
+        {}
+
+        std::uint64_t find(char item) const
+        {
+            return static_cast<std::uint32_t>( _mm256_movemask_epi8( _mm256_cmpeq_epi8(_data, _mm256_set1_epi8(item)) ) );
+        }
+
+        __m256i _data;
+    };
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    constexpr size_t blockSize = 16;
+    constexpr unsigned bitsPerByte = 1;
+
+    struct block
+    {
+        explicit block(const char* data) : _data( _mm_loadu_si128( reinterpret_cast<const __m128i*>(data) ) )
+        {}
+
+        std::uint64_t find(char item) const
+        {
+            return static_cast<std::uint32_t>( _mm_movemask_epi8( _mm_cmpeq_epi8(_data, _mm_set1_epi8(item)) ) );
+        }
+
+        __m128i _data;
+    };
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+    constexpr size_t blockSize = 16;
+    constexpr unsigned bitsPerByte = 4;
+
+    struct block
+    {
+        explicit block(const char* data) : _data( vld1q_u8( reinterpret_cast<const std::uint8_t*>(data) ) )
+        {}
+
+        // NEON has no movemask, narrowing the compare result leaves four bits per byte
+        std::uint64_t find(char item) const
+        {
+            uint8x16_t equal = vceqq_u8( _data, vdupq_n_u8( static_cast<std::uint8_t>(item) ) );
+            return vget_lane_u64(vreinterpret_u64_u8( vshrn_n_u16(vreinterpret_u16_u8(equal), 4) ), 0);
+        }
+
+        uint8x16_t _data;
+    };
+#endif
+
+#if defined(INIFILE_SIMD)
+    size_t firstByte(std::uint64_t mask)
+    {
+    #if defined(_MSC_VER)
+        unsigned long bit;
+        _BitScanForward64(&bit, mask);
+        return bit / bitsPerByte;
+    #else
+        return static_cast<size_t>( __builtin_ctzll(mask) ) / bitsPerByte;
+    #endif
+    }
+
+    size_t lastByte(std::uint64_t mask)
+    {
+    #if defined(_MSC_VER)
+        unsigned long bit;
+        _BitScanReverse64(&bit, mask);
+        return bit / bitsPerByte;
+    #else
+        return static_cast<size_t>( 63 - __builtin_clzll(mask) ) / bitsPerByte;
+    #endif
+    }
+#endif
+
+    parser::lineMarks scanBytes(std::string_view text, size_t pos, parser::lineMarks marks)
+    {
+        constexpr size_t npos = std::string_view::npos;
+
+        for (; pos < text.size(); ++pos)
+        {
+            switch (text[pos])
+            {
+                case '\n':
+                    marks._length = pos;
+                    return marks;
+
+                case '[':
+                    if (marks._leftBracket == npos)
+                    {
+                        marks._leftBracket = pos;
+                    }
+                    break;
+
+                case ']':
+                    marks._rightBracket = pos;
+                    break;
+
+                case '=':
+                    if (marks._equal == npos)
+                    {
+                        marks._equal = pos;
+                    }
+                    break;
+
+                case ';':
+                    if (marks._comment == npos)
+                    {
+                        marks._comment = pos;
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        return marks;
+    }
+}
+
+parser::lineMarks parser::scanLine(std::string_view text)
+{
+    constexpr size_t npos = std::string_view::npos;
+
+    lineMarks marks{text.size(), npos, npos, npos, npos};
+    size_t pos = 0;
+
+#if defined(INIFILE_SIMD)
+    for (; pos + blockSize <= text.size(); pos += blockSize)
+    {
+        block item(text.data() + pos);
+
+        std::uint64_t newline = item.find('\n');
+        std::uint64_t limit = newline == 0 ? ~std::uint64_t(0) : (newline & (~newline + 1)) - 1;
+
+        std::uint64_t leftBracket = item.find('[') & limit;
+        std::uint64_t rightBracket = item.find(']') & limit;
+        std::uint64_t equal = item.find('=') & limit;
+        std::uint64_t comment = item.find(';') & limit;
+
+        if (marks._leftBracket == npos && leftBracket != 0)
+        {
+            marks._leftBracket = pos + firstByte(leftBracket);
+        }
+
+        if (rightBracket != 0)
+        {
+            marks._rightBracket = pos + lastByte(rightBracket);
+        }
+
+        if (marks._equal == npos && equal != 0)
+        {
+            marks._equal = pos + firstByte(equal);
+        }
+
+        if (marks._comment == npos && comment != 0)
+        {
+            marks._comment = pos + firstByte(comment);
+        }
+
+        if (newline != 0)
+        {
+            marks._length = pos + firstByte(newline);
+            return marks;
+        }
+    }
+#endif
+
+    return scanBytes(text, pos, marks);
+}
+
+parser::lineMarks parser::scanLineScalar(std::string_view text)
+{
+    constexpr size_t npos = std::string_view::npos;
+
+    return scanBytes(text, 0, {text.size(), npos, npos, npos, npos});
+}
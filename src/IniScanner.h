@@ -0,0 +1,29 @@
+#ifndef INISCANNER_H
+#define INISCANNER_H
+
+#include <string_view>
+
+
+namespace parser
+{
+    // Positions inside one line, npos when the character is absent
+    struct lineMarks
+    {
+        size_t _length;
+        size_t _leftBracket;
+        size_t _rightBracket;
+        size_t _equal;
+        size_t _comment;
+    };
+
+    // Finds the end of the first line of text together with its first '[', last ']', first '=' and
+    // first ';' in one pass, using SSE2, AVX2 or NEON blocks when the target has them.
+    // INIFILE_SCALAR_SCAN turns the blocks off
+    lineMarks scanLine(std::string_view text);
+
+    // Same result one byte at a time, scanLine finishes the last partial block with it
+    lineMarks scanLineScalar(std::string_view text);
+}
+
+
+#endif //INISCANNER_H
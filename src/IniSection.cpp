@@ -1,53 +1,32 @@
 #include "IniSection.h"
 
-IniSection::IniSection(std::string section, size_t index, size_t lineNum)
-        : _name(std::move(section)), _index(index), _lineNum(lineNum)
-{}
-
-IniSection::IniSection(const char* section, size_t index, size_t lineNum)
+IniSection::IniSection(std::string_view section, size_t index, size_t lineNum)
         : _name(section), _index(index), _lineNum(lineNum)
 {}
 
-IniSection::IniSection(const IniSection& other) : IniSection(other._name, other._index, other._lineNum)
+IniSection::IniSection(const std::string& section, size_t index, size_t lineNum)
+        : IniSection(std::string_view(section), index, lineNum)
 {}
 
-IniSection& IniSection::operator=(const IniSection& other)
-{
-    if (this == &other)
-    {
-        return *this;
-    }
-
-    IniSection copy(other);
-    *this = std::move(copy);
-
-    return *this;
-}
+IniSection::IniSection(const char* section, size_t index, size_t lineNum)
+        : IniSection(std::string_view(section), index, lineNum)
+{}
 
-IniSection::IniSection(IniSection&& other)
+IniSection::operator std::string() const
 {
-    *this = std::move(other);
+    return std::string(_name);
 }
 
-IniSection& IniSection::operator=(IniSection&& other)
+std::string operator+(const std::string& str, const IniSection& section)
 {
-    std::swap(this->_name, other._name);
-    std::swap(this->_index, other._index);
-    std::swap(this->_lineNum, other._lineNum);
-
-    return *this;
+    return str + std::string(section._name);
 }
 
-IniSection::operator std::string() const
+std::string_view IniSection::getName() const
 {
     return _name;
 }
 
-std::string operator+(const std::string& str, const IniSection& section)
-{
-    return str + section._name;
-}
-
 size_t IniSection::getIndex() const
 {
     return _index;
@@ -56,4 +35,4 @@ size_t IniSection::getIndex() const
 size_t IniSection::getLineNum() const
 {
     return _lineNum;
-}
\ No newline at end of file
+}
@@ -2,33 +2,37 @@
 #define INISECTION_H
 
 #include <string>
-#include <utility>
+#include <string_view>
+#include <type_traits>
 
 
+// Trivially copyable handle. Built from your own string it only views that string, so keep it alive
+// while the handle is used; a temporary std::string is refused. Handles returned by an IniFile view
+// names stored in its name pool and stay valid while that file lives, those of a FrozenIniFile view
+// its storage.
 struct IniSection
 {
 public:
-    IniSection(std::string section, size_t index = 0, size_t lineNum = 0);
+    IniSection(std::string_view section, size_t index = 0, size_t lineNum = 0);
+    IniSection(const std::string& section, size_t index = 0, size_t lineNum = 0);
+    IniSection(std::string&& section, size_t index = 0, size_t lineNum = 0) = delete;
     IniSection(const char* section, size_t index = 0, size_t lineNum = 0);
 
-    explicit IniSection(const IniSection& other);
-    IniSection& operator=(const IniSection& other);
-
-    explicit IniSection(IniSection&& other);
-    IniSection& operator=(IniSection&& other);
-
     operator std::string() const;
 
     friend std::string operator+(const std::string& str, const IniSection& section);
 
+    std::string_view getName() const;
     size_t getIndex() const;
     size_t getLineNum() const;
 
 private:
-    std::string _name;
+    std::string_view _name;
     size_t _index;
     size_t _lineNum;
 };
 
+static_assert(std::is_trivially_copyable_v<IniSection>);
+
 
 #endif //INISECTION_H
@@ -0,0 +1,120 @@
+#include "IniStats.h"
+
+#include <functional>
+
+void IniStatsSink::onLoad(const std::string&, size_t, size_t, std::chrono::nanoseconds)
+{}
+
+void IniStatsSink::onSave(const std::string&, size_t, std::chrono::nanoseconds)
+{}
+
+void IniStatsSink::onLookup(std::string_view, std::string_view, bool, bool)
+{}
+
+void IniStatsSink::onError(const std::string&, const std::string&)
+{}
+
+void IniCounters::onLoad(const std::string&, size_t bytes, size_t lines, std::chrono::nanoseconds time)
+{
+    _loads.fetch_add(1, std::memory_order_relaxed);
+    _bytesParsed.fetch_add(bytes, std::memory_order_relaxed);
+    _linesParsed.fetch_add(lines, std::memory_order_relaxed);
+    _loadTime.fetch_add(time.count(), std::memory_order_relaxed);
+}
+
+void IniCounters::onSave(const std::string&, size_t bytes, std::chrono::nanoseconds time)
+{
+    _saves.fetch_add(1, std::memory_order_relaxed);
+    _bytesSaved.fetch_add(bytes, std::memory_order_relaxed);
+    _saveTime.fetch_add(time.count(), std::memory_order_relaxed);
+}
+
+void IniCounters::onLookup(std::string_view section, std::string_view, bool, bool keyFound)
+{
+    _lookups.fetch_add(1, std::memory_order_relaxed);
+
+    if ( !keyFound )
+    {
+        _defaultHits.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    size_t hash = std::hash<std::string_view>{}(section);
+
+    for (size_t probe = 0; probe < probeLimit; ++probe)
+    {
+        sectionSlot& slot = _sections[(hash + probe) & (sectionLimit - 1)];
+        const std::string* name = slot._name.load(std::memory_order_acquire);
+
+        if (name == nullptr)
+        {
+            auto* created = new std::string(section);
+
+            if ( slot._name.compare_exchange_strong(name, created, std::memory_order_release, std::memory_order_acquire) )
+            {
+                count(slot, keyFound);
+                return;
+            }
+
+            // Another thread claimed the slot first, compare with its name
+            delete created;
+        }
+
+        if (*name == section)
+        {
+            count(slot, keyFound);
+            return;
+        }
+    }
+
+    count(_otherSections, keyFound);
+}
+
+IniCounters::~IniCounters()
+{
+    for (sectionSlot& slot : _sections)
+    {
+        delete slot._name.load(std::memory_order_relaxed);
+    }
+}
+
+void IniCounters::count(sectionSlot& slot, bool keyFound)
+{
+    slot._lookups.fetch_add(1, std::memory_order_relaxed);
+
+    if ( !keyFound )
+    {
+        slot._misses.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void IniCounters::onError(const std::string&, const std::string&)
+{
+    _errors.fetch_add(1, std::memory_order_relaxed);
+}
+
+IniCounters::values IniCounters::snapshot() const
+{
+    return {_loads.load(), _bytesParsed.load(), _linesParsed.load(), std::chrono::nanoseconds( _loadTime.load() ),
+            _saves.load(), _bytesSaved.load(), std::chrono::nanoseconds( _saveTime.load() ),
+            _lookups.load(), _defaultHits.load(), _errors.load()};
+}
+
+std::unordered_map<std::string, IniCounters::sectionValues> IniCounters::sections() const
+{
+    std::unordered_map<std::string, sectionValues> sections;
+
+    for (const sectionSlot& slot : _sections)
+    {
+        if (const std::string* name = slot._name.load(std::memory_order_acquire))
+        {
+            sections.emplace(*name, sectionValues{slot._lookups.load(), slot._misses.load()});
+        }
+    }
+
+    return sections;
+}
+
+IniCounters::sectionValues IniCounters::otherSections() const
+{
+    return {_otherSections._lookups.load(), _otherSections._misses.load()};
+}
@@ -0,0 +1,114 @@
+#ifndef INISTATS_H
+#define INISTATS_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+
+// Hooks are compiled in only with INIFILE_STATS defined, and cost one pointer test when no sink is set
+#if defined(INIFILE_STATS)
+    #define INIFILE_STAT(sink, call) do { if (sink) { (sink)->call; } } while (false)
+#else
+    #define INIFILE_STAT(sink, call) do {} while (false)
+#endif
+
+
+// Receiver of IniFile events, called from the thread that runs the operation
+class IniStatsSink
+{
+public:
+    virtual ~IniStatsSink() = default;
+
+    virtual void onLoad(const std::string& path, size_t bytes, size_t lines, std::chrono::nanoseconds time);
+    virtual void onSave(const std::string& path, size_t bytes, std::chrono::nanoseconds time);
+
+    // Every read<T>, keyFound is false when the default value was returned
+    virtual void onLookup(std::string_view section, std::string_view key, bool sectionFound, bool keyFound);
+
+    virtual void onError(const std::string& path, const std::string& message);
+};
+
+
+// Sink that sums everything up, safe to share between IniFiles and threads
+class IniCounters : public IniStatsSink
+{
+public:
+    struct values
+    {
+        size_t _loads;
+        size_t _bytesParsed;
+        size_t _linesParsed;
+        std::chrono::nanoseconds _loadTime;
+
+        size_t _saves;
+        size_t _bytesSaved;
+        std::chrono::nanoseconds _saveTime;
+
+        size_t _lookups;
+        size_t _defaultHits;
+        size_t _errors;
+    };
+
+    struct sectionValues
+    {
+        size_t _lookups = 0;
+        size_t _misses = 0;
+    };
+
+    void onLoad(const std::string& path, size_t bytes, size_t lines, std::chrono::nanoseconds time) override;
+    void onSave(const std::string& path, size_t bytes, std::chrono::nanoseconds time) override;
+    void onLookup(std::string_view section, std::string_view key, bool sectionFound, bool keyFound) override;
+    void onError(const std::string& path, const std::string& message) override;
+
+    IniCounters() = default;
+    ~IniCounters() override;
+
+    IniCounters(const IniCounters&) = delete;
+    IniCounters& operator=(const IniCounters&) = delete;
+
+    values snapshot() const;
+
+    // Lookups and misses per section name, a miss returned the default value. At most sectionLimit names
+    // get their own counters: a new name takes a free slot among the few its hash points at, and once
+    // those are taken it is summed in otherSections() for good
+    std::unordered_map<std::string, sectionValues> sections() const;
+    sectionValues otherSections() const;
+
+    static constexpr size_t sectionLimit = 1024;
+
+private:
+    // Claimed once by the first lookup of a name, later lookups only add to the counters
+    struct sectionSlot
+    {
+        std::atomic<const std::string*> _name{nullptr};
+        std::atomic<size_t> _lookups{0};
+        std::atomic<size_t> _misses{0};
+    };
+
+    static void count(sectionSlot& slot, bool keyFound);
+
+    std::atomic<size_t> _loads{0};
+    std::atomic<size_t> _bytesParsed{0};
+    std::atomic<size_t> _linesParsed{0};
+    std::atomic<long long> _loadTime{0};
+
+    std::atomic<size_t> _saves{0};
+    std::atomic<size_t> _bytesSaved{0};
+    std::atomic<long long> _saveTime{0};
+
+    std::atomic<size_t> _lookups{0};
+    std::atomic<size_t> _defaultHits{0};
+    std::atomic<size_t> _errors{0};
+
+    // Slots are never freed, so a name that found its probes taken never gets a slot later
+    static constexpr size_t probeLimit = 16;
+
+    sectionSlot _sections[sectionLimit];
+    sectionSlot _otherSections;
+};
+
+
+#endif //INISTATS_H
@@ -0,0 +1,64 @@
+#ifndef INIVALUE_H
+#define INIVALUE_H
+
+#include "IniNumber.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+
+namespace alias
+{
+    constexpr std::array<const char*, 4> trueValue = {"true", "on", "yes", "1"};
+    constexpr auto computerTruePrint = "true";
+    constexpr auto computerFalsePrint = "false";
+}
+
+namespace parser
+{
+    // Returns nullptr on success, otherwise the reason why text isn't a T
+    template<typename T>
+    const char* parseValue(std::string_view text, T& value)
+    {
+        if constexpr ( std::is_same_v<T, bool> )
+        {
+            value = std::any_of(alias::trueValue.begin(), alias::trueValue.end(), [text](std::string_view alias){
+                return std::equal(text.begin(), text.end(), alias.begin(), alias.end(), [](unsigned char a, unsigned char b){
+                    return std::tolower(a) == b;
+                });
+            });
+        }
+        else if constexpr ( std::is_same_v<T, char> )
+        {
+            if (text.size() != 1)
+            {
+                return text.empty() ? "empty character value" : "more than one character";
+            }
+
+            value = text.front();
+        }
+        else if constexpr ( std::is_same_v<T, std::string> )
+        {
+            value.assign( text.begin(), text.end() );
+        }
+        else if constexpr (std::is_integral_v<T> || std::is_floating_point_v<T>)
+        {
+            return parseNumber(text, value);
+        }
+        else
+        {
+            std::istringstream stream{ std::string(text) };
+            stream >> value;
+        }
+
+        return nullptr;
+    }
+}
+
+
+#endif //INIVALUE_H
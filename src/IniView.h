@@ -0,0 +1,122 @@
+#ifndef INIVIEW_H
+#define INIVIEW_H
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+
+// Non-owning range over [begin, end) of an underlying container, items are converted on dereference.
+// Valid until the container is modified
+template<typename Iterator, typename Convert>
+class IniView
+{
+public:
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = decltype( std::declval<const Convert&>()(*std::declval<Iterator>()) );
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        iterator(Iterator it, Convert convert);
+
+        value_type operator*() const;
+
+        iterator& operator++();
+        iterator operator++(int);
+
+        bool operator==(const iterator& other) const;
+        bool operator!=(const iterator& other) const;
+
+    private:
+        Iterator _it;
+        Convert _convert;
+    };
+
+    IniView(Iterator begin, Iterator end, Convert convert = {});
+
+    iterator begin() const;
+    iterator end() const;
+
+    size_t size() const;
+    bool empty() const;
+
+private:
+    Iterator _begin;
+    Iterator _end;
+    Convert _convert;
+};
+
+
+template<typename Iterator, typename Convert>
+IniView<Iterator, Convert>::iterator::iterator(Iterator it, Convert convert) : _it(it), _convert(convert)
+{}
+
+template<typename Iterator, typename Convert>
+typename IniView<Iterator, Convert>::iterator::value_type IniView<Iterator, Convert>::iterator::operator*() const
+{
+    return _convert(*_it);
+}
+
+template<typename Iterator, typename Convert>
+typename IniView<Iterator, Convert>::iterator& IniView<Iterator, Convert>::iterator::operator++()
+{
+    ++_it;
+    return *this;
+}
+
+template<typename Iterator, typename Convert>
+typename IniView<Iterator, Convert>::iterator IniView<Iterator, Convert>::iterator::operator++(int)
+{
+    iterator copy = *this;
+    ++_it;
+
+    return copy;
+}
+
+template<typename Iterator, typename Convert>
+bool IniView<Iterator, Convert>::iterator::operator==(const iterator& other) const
+{
+    return _it == other._it;
+}
+
+template<typename Iterator, typename Convert>
+bool IniView<Iterator, Convert>::iterator::operator!=(const iterator& other) const
+{
+    return _it != other._it;
+}
+
+template<typename Iterator, typename Convert>
+IniView<Iterator, Convert>::IniView(Iterator begin, Iterator end, Convert convert)
+        : _begin(begin), _end(end), _convert(convert)
+{}
+
+template<typename Iterator, typename Convert>
+typename IniView<Iterator, Convert>::iterator IniView<Iterator, Convert>::begin() const
+{
+    return {_begin, _convert};
+}
+
+template<typename Iterator, typename Convert>
+typename IniView<Iterator, Convert>::iterator IniView<Iterator, Convert>::end() const
+{
+    return {_end, _convert};
+}
+
+template<typename Iterator, typename Convert>
+size_t IniView<Iterator, Convert>::size() const
+{
+    return static_cast<size_t>( std::distance(_begin, _end) );
+}
+
+template<typename Iterator, typename Convert>
+bool IniView<Iterator, Convert>::empty() const
+{
+    return _begin == _end;
+}
+
+
+#endif //INIVIEW_H
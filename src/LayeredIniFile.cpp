@@ -0,0 +1,141 @@
+#include "LayeredIniFile.h"
+
+bool LayeredIniFile::slot::operator==(const slot& other) const
+{
+    return _section == other._section && _key == other._key;
+}
+
+std::size_t LayeredIniFile::slotHash::operator()(const slot& item) const noexcept
+{
+    return parser::seededHash(item._section) * 31 ^ parser::seededHash(item._key);
+}
+
+LayeredIniFile::LayeredIniFile(const std::vector<std::string>& paths, LoadMode mode)
+{
+    _layers.reserve( paths.size() );
+
+    for (const auto& path : paths)
+    {
+        _layers.emplace_back(path);
+        _layers.back().load(mode);
+    }
+
+    for (const auto& file : _layers)
+    {
+        for (IniFile::SectionRef section : file.sectionsView())
+        {
+            if (section.getIndex() == 0 && _sectionKeys.find( section.getName() ) == _sectionKeys.end())
+            {
+                merge( section.getName() );
+            }
+        }
+    }
+}
+
+bool LayeredIniFile::sectionExists(std::string_view section) const
+{
+    return _sectionKeys.find(section) != _sectionKeys.end();
+}
+
+bool LayeredIniFile::keyExists(std::string_view section, std::string_view key) const
+{
+    return layerOf(section, key) != npos;
+}
+
+size_t LayeredIniFile::layerOf(std::string_view section, std::string_view key) const
+{
+    auto it = _winners.find({section, key});
+    return it == _winners.end() ? npos : it->second;
+}
+
+std::vector<std::string> LayeredIniFile::keys(std::string_view section) const
+{
+    auto it = _sectionKeys.find(section);
+
+    if (it == _sectionKeys.end())
+    {
+        return {};
+    }
+
+    return {it->second.begin(), it->second.end()};
+}
+
+size_t LayeredIniFile::layerCount() const
+{
+    return _layers.size();
+}
+
+const IniFile& LayeredIniFile::layer(size_t pos) const
+{
+    return _layers.at(pos);
+}
+
+IniDiff LayeredIniFile::reload(size_t layer)
+{
+    IniDiff diff = _layers.at(layer).reload();
+
+    for (const auto* sections : {&diff._addedSections, &diff._removedSections, &diff._changedSections})
+    {
+        for (const IniSection& section : *sections)
+        {
+            merge( section.getName() );
+        }
+    }
+
+    return diff;
+}
+
+void LayeredIniFile::enableCache(bool enabled)
+{
+    for (auto& file : _layers)
+    {
+        file.enableCache(enabled);
+    }
+}
+
+void LayeredIniFile::merge(std::string_view section)
+{
+    std::string_view name = *_names.intern(section);
+    auto keysIt = _sectionKeys.find(name);
+
+    if (keysIt != _sectionKeys.end())
+    {
+        for (std::string_view key : keysIt->second)
+        {
+            _winners.erase({name, key});
+        }
+
+        keysIt->second.clear();
+    }
+
+    bool found = false;
+
+    for (size_t pos = 0; pos < _layers.size(); ++pos)
+    {
+        if ( !_layers[pos].sectionExists(name) )
+        {
+            continue;
+        }
+
+        if ( !found )
+        {
+            keysIt = _sectionKeys.try_emplace(name).first;
+            found = true;
+        }
+
+        for (IniFile::KeyValue item : _layers[pos].keysView(name))
+        {
+            auto [it, added] = _winners.insert_or_assign({name, *_names.intern(item._key)}, pos);
+
+            if (added)
+            {
+                keysIt->second.push_back(it->first._key);
+            }
+        }
+    }
+
+    if ( !found && keysIt != _sectionKeys.end() )
+    {
+        _sectionKeys.erase(keysIt);
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef LAYEREDINIFILE_H
+#define LAYEREDINIFILE_H
+
+#include "IniFile.h"
+#include "IniNamePool.h"
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+// Several files read as one, a key in a later layer overrides the same key in earlier ones.
+// Which layer wins is kept in one merged index, so a read probes it once and then only the winning
+// layer. As with string section reads, every layer contributes the first section of a name
+class LayeredIniFile
+{
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    // Loads every path, from the base layer to the most specific one
+    explicit LayeredIniFile(const std::vector<std::string>& paths, LoadMode mode = LoadMode::Buffered);
+
+    LayeredIniFile(const LayeredIniFile& other) = delete;
+    LayeredIniFile& operator=(const LayeredIniFile& other) = delete;
+
+    template<typename T>
+    T read(std::string_view section, std::string_view key, T defaultValue = T{}) const;
+
+    bool sectionExists(std::string_view section) const;
+    bool keyExists(std::string_view section, std::string_view key) const;
+
+    // Layer the value of key comes from, npos when no layer has it
+    size_t layerOf(std::string_view section, std::string_view key) const;
+
+    // Merged keys of section in the order they first appear from the base layer on
+    std::vector<std::string> keys(std::string_view section) const;
+
+    size_t layerCount() const;
+    const IniFile& layer(size_t pos) const;
+
+    // Re-reads one layer, only sections named in its diff are merged again
+    IniDiff reload(size_t layer);
+
+    void enableCache(bool enabled = true);
+
+private:
+    struct slot
+    {
+        std::string_view _section;
+        std::string_view _key;
+
+        bool operator==(const slot& other) const;
+    };
+
+    struct slotHash
+    {
+        std::size_t operator()(const slot& item) const noexcept;
+    };
+
+    std::vector<IniFile> _layers;
+
+    // Names outlive the layer text they came from, a reload drops it
+    IniNamePool _names;
+    std::unordered_map<slot, size_t, slotHash> _winners;
+    std::unordered_map<std::string_view, std::vector<std::string_view>, parser::seededHasher> _sectionKeys;
+
+    void merge(std::string_view section);
+};
+
+
+template<typename T>
+T LayeredIniFile::read(std::string_view section, std::string_view key, T defaultValue) const
+{
+    size_t pos = layerOf(section, key);
+
+    if (pos == npos)
+    {
+        return defaultValue;
+    }
+
+    return _layers[pos].read<T>(section, key, std::move(defaultValue));
+}
+
+
+#endif //LAYEREDINIFILE_H
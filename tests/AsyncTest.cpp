@@ -0,0 +1,169 @@
+#include "IniFile.h"
+#include "Check.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    void write(const std::string& path, const std::string& text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    std::string contents(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    template<typename F>
+    std::string error(F&& body)
+    {
+        try
+        {
+            body();
+        }
+        catch (const std::runtime_error& exception)
+        {
+            return exception.what();
+        }
+
+        return "";
+    }
+
+    template<typename T>
+    bool ready(const std::future<T>& future)
+    {
+        return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    // Keeps the tasks until run() so the test sees when they happen
+    struct queue
+    {
+        std::vector<std::function<void()>> _tasks;
+
+        IniExecutor executor()
+        {
+            return [this](std::function<void()> task){ _tasks.push_back(std::move(task)); };
+        }
+
+        void run()
+        {
+            for (auto& task : _tasks)
+            {
+                task();
+            }
+
+            _tasks.clear();
+        }
+    };
+
+    void onExecutor(const std::string& path)
+    {
+        write(path, "[a]\nx=1\n");
+
+        queue tasks;
+        IniFile file(path);
+
+        std::future<void> loaded = file.loadAsync(LoadMode::Mapped, 1, tasks.executor());
+        check( !ready(loaded) && tasks._tasks.size() == 1, "load waits for the executor");
+
+        tasks.run();
+        loaded.get();
+        check(file.read<int>("a", "x") == 1, "loaded by the executor");
+
+        write(path, "[a]\nx=2\n\n[b]\ny=3\n");
+
+        std::future<IniDiff> reloaded = file.reloadAsync(tasks.executor());
+        tasks.run();
+        IniDiff diff = reloaded.get();
+
+        check(diff._addedSections.size() == 1 && diff._changedSections.size() == 1 && file.read<int>("a", "x") == 2,
+              "reload diff returned by get()");
+
+        file.writeKeyValue<int>("b", "y", 4);
+
+        std::future<void> saved = file.saveAsync(tasks.executor());
+        check( !ready(saved) && contents(path) == "[a]\nx=2\n\n[b]\ny=3\n", "save waits for the executor");
+
+        // Reads are allowed while saving
+        std::thread runner([&](){ tasks.run(); });
+        int read = file.read<int>("b", "y");
+        runner.join();
+        saved.get();
+
+        check(read == 4 && contents(path) == "[a]\nx = 2\n\n[b]\ny = 4\n\n", "saved by the executor");
+    }
+
+    void onThread(const std::string& path)
+    {
+        write(path, "[a]\nx=5\n");
+
+        IniFile file(path);
+        file.loadAsync().get();
+        check(file.read<int>("a", "x") == 5, "load on a new thread");
+
+        write(path, "[a]\nx=6\n");
+        check(file.reloadAsync().get()._changedKeys.size() == 1 && file.read<int>("a", "x") == 6, "reload on a new thread");
+
+        file.writeKeyValue<int>("a", "x", 7);
+        file.saveAsync().get();
+        check(contents(path) == "[a]\nx = 7\n\n", "save on a new thread");
+    }
+
+    // get() rethrows what the blocking call would throw
+    void errors(const std::string& path)
+    {
+        write(path, "[a]\nx=1\n=\n");
+
+        std::string expected = error([&](){ IniFile(path).load(); });
+        check(expected == "empty key or value in line: 3", "sequential error");
+
+        queue tasks;
+        IniFile file(path);
+        std::future<void> loaded = file.loadAsync(LoadMode::Buffered, 1, tasks.executor());
+        tasks.run();
+        check(error([&](){ loaded.get(); }) == expected, "load error from the executor");
+
+        IniFile other(path);
+        check(error([&](){ other.loadAsync(LoadMode::Mapped).get(); }) == expected, "load error from a new thread");
+
+        write(path, "[a]\nx=1\n");
+        file.load();
+        write(path, "[a]\nx=1\n=\n");
+
+        std::future<IniDiff> reloaded = file.reloadAsync(tasks.executor());
+        tasks.run();
+        check(error([&](){ reloaded.get(); }) == expected && file.read<int>("a", "x") == 1, "reload error keeps the file");
+
+        IniFile unwritable( (std::filesystem::temp_directory_path() / "IniFileAsyncTest.missing" / "file.ini").string() );
+        unwritable.writeKeyValue<int>(unwritable.writeSection("s"), "k", 1);
+
+        std::future<void> saved = unwritable.saveAsync(tasks.executor());
+        tasks.run();
+        check(error([&](){ saved.get(); }) == "can't save IniFile", "save error from the executor");
+        check(error([&](){ unwritable.saveAsync().get(); }) == "can't save IniFile", "save error from a new thread");
+    }
+}
+
+int main()
+{
+    std::string path = (std::filesystem::temp_directory_path() / "IniFileAsyncTest.ini").string();
+
+    onExecutor(path);
+    onThread(path);
+    errors(path);
+
+    std::filesystem::remove(path);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+#include "IniBuilder.h"
+#include "IniFile.h"
+#include "Check.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    void write(const std::string& path, const std::string& text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    std::string contents(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    template<typename F>
+    std::string error(F&& body)
+    {
+        try
+        {
+            body();
+        }
+        catch (const std::runtime_error& exception)
+        {
+            return exception.what();
+        }
+
+        return "";
+    }
+
+    void build(const std::string& path)
+    {
+        write(path, "[a]\nx=1\n");
+
+        IniFile file(path);
+        file.load();
+
+        {
+            IniBuilder builder(file);
+            builder.reserve(3, 4);
+            builder.section("b").add("int", 42).add("double", 0.25).add("bool", true).add("char", 'c');
+            builder.section("a").add("text", "words").add("string", std::string("copied"));
+
+            check(builder.sectionCount() == 2 && file.sections().size() == 1 && !file.sectionExists("b"),
+                  "nothing in the file before commit()");
+
+            builder.commit();
+            check(builder.sectionCount() == 0, "builder empty after commit()");
+
+            // Used again, also for a name it started before
+            builder.section("b").add("second", -7);
+            builder.commit();
+
+            builder.section("never").add("k", 1);
+        }
+
+        check( !file.sectionExists("never"), "dropped without commit()");
+
+        check(file.read<int>("b", "int") == 42 && file.read<double>("b", "double") == 0.25 && file.read<bool>("b", "bool") &&
+              file.read<char>("b", "char") == 'c', "typed values");
+
+        check(file.read<int>("a", "x") == 1 && file.read<std::string>(IniSection("a", 1), "text") == "words" &&
+              file.read<std::string>(IniSection("a", 1), "string") == "copied", "duplicate of a loaded section");
+
+        check(file.sectionCount("b") == 2 && file.read<int>(IniSection("b", 1), "second") == -7 &&
+              file.keys(IniSection("b", 1)).size() == 1, "duplicate of a built section");
+
+        // Written like the rest of the file
+        file.writeKeyValue<int>(IniSection("b", 1), "second", 8);
+        file.save();
+        check(contents(path) == "[a]\nx = 1\n\n[b]\nint = 42\ndouble = 0.25\nbool = true\nchar = c\n\n"
+                                "[a]\ntext = words\nstring = copied\n\n[b]\nsecond = 8\n\n", "saved in build order");
+    }
+
+    void pooled(const std::string& path)
+    {
+        write(path, "[a]\nx=1\n");
+
+        auto pool = std::make_shared<IniNamePool>();
+        IniFile file(path);
+        file.setNamePool(pool);
+        file.load();
+
+        IniBuilder builder(file);
+        builder.section("a").add("x", 2).add("y", 3);
+        builder.commit();
+
+        check(pool->size() == 3 && file.sections()[1].getName().data() == file.sections()[0].getName().data(),
+              "names interned in the file's pool");
+        check(file.read<int>(IniSection("a", 1), "x") == 2 && file.read<int>(IniSection("a", 1), "y") == 3, "values of a pooled file");
+    }
+
+    void errors(const std::string& path)
+    {
+        IniFile file(path);
+        IniBuilder builder(file);
+
+        check(error([&](){ builder.add("k", 1); }) == "key and value without section: k", "no section");
+
+        builder.section("s").add("k", 1);
+
+        check(error([&](){ builder.add("k", 2); }) == "duplicate key: k", "duplicate key");
+        check(error([&](){ builder.add("", 2); }) == "empty key or value: " && error([&](){ builder.add("e", ""); }) == "empty key or value: e",
+              "empty key or value");
+
+        builder.commit();
+        check(file.read<int>("s", "k") == 1 && file.keys("s").size() == 1, "errors leave the rest to commit");
+    }
+}
+
+int main()
+{
+    std::string path = (std::filesystem::temp_directory_path() / "IniFileBuilderTest.ini").string();
+
+    build(path);
+    pooled(path);
+    errors(path);
+
+    std::filesystem::remove(path);
+
+    return failures == 0 ? 0 : 1;
+}
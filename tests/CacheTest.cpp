@@ -0,0 +1,113 @@
+#include "IniFile.h"
+#include "Check.h"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    void write(const std::string& path, const std::string& text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    void values(const std::string& path)
+    {
+        write(path, "[s]\na=1\nb=2.5\nc=true\n");
+
+        IniFile file(path);
+        file.load();
+        file.enableCache();
+
+        check(file.read<int>("s", "a") == 1 && file.read<int>("s", "a") == 1, "cached int");
+        check(file.read<double>("s", "a") == 1.0 && file.read<long>("s", "a") == 1, "one key cached as several types");
+        check(file.read<double>("s", "b") == 2.5 && file.read<bool>("s", "c"), "other keys");
+
+        file.writeKeyValue<int>("s", "a", 7);
+        check(file.read<int>("s", "a") == 7 && file.read<double>("s", "a") == 7.0, "rewritten key parsed again");
+
+        file.writeKeyValue<int>("s", "d", 4);
+        check(file.read<int>("s", "d") == 4 && file.read<int>("s", "d") == 4 && file.read<int>("s", "a") == 7,
+              "key added after the cache was filled");
+
+        file.enableCache(false);
+        file.writeKeyValue<int>("s", "a", 8);
+        check(file.read<int>("s", "a") == 8, "disabled cache");
+    }
+
+    // Many readers fill the same slots at once, every read must see the value
+    void threads(const std::string& path)
+    {
+        std::string text = "[s]\n";
+
+        for (int i = 0; i < 64; ++i)
+        {
+            text += "k" + std::to_string(i) + '=' + std::to_string(i) + '\n';
+        }
+
+        write(path, text);
+
+        IniFile file(path);
+        file.load();
+        file.enableCache();
+
+        std::atomic<int> wrong{0};
+        std::vector<std::thread> readers;
+
+        for (int t = 0; t < 8; ++t)
+        {
+            readers.emplace_back([&](){
+                for (int round = 0; round < 200; ++round)
+                {
+                    for (int i = 0; i < 64; ++i)
+                    {
+                        std::string key = "k" + std::to_string(i);
+                        wrong += file.read<int>("s", key) != i;
+                        wrong += file.read<double>("s", key) != i;
+                    }
+                }
+            });
+        }
+
+        for (auto& reader : readers)
+        {
+            reader.join();
+        }
+
+        check(wrong == 0, "concurrent cached reads");
+    }
+
+    void reload(const std::string& path)
+    {
+        write(path, "[a]\nx=1\n\n[b]\ny=2\n");
+
+        IniFile file(path);
+        file.load();
+        file.enableCache();
+
+        check(file.read<int>("a", "x") == 1 && file.read<int>("b", "y") == 2, "reload: first reads");
+
+        write(path, "[a]\nx=1\n\n[b]\ny=3\n");
+        file.reload();
+
+        check(file.read<int>("a", "x") == 1 && file.read<int>("b", "y") == 3, "reload: changed value parsed again");
+    }
+}
+
+int main()
+{
+    std::string path = (std::filesystem::temp_directory_path() / "IniFileCacheTest.ini").string();
+
+    values(path);
+    threads(path);
+    reload(path);
+
+    std::filesystem::remove(path);
+
+    return failures == 0 ? 0 : 1;
+}
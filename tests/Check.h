@@ -0,0 +1,21 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <iostream>
+#include <string>
+
+
+// Failed checks of one test executable, main returns 1 when there are any
+inline int failures = 0;
+
+inline void check(bool condition, const std::string& message)
+{
+    if ( !condition )
+    {
+        std::cerr << "FAILED: " << message << '\n';
+        ++failures;
+    }
+}
+
+
+#endif //CHECK_H
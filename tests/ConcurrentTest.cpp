@@ -0,0 +1,131 @@
+#include "ConcurrentIniFile.h"
+#include "Check.h"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    void write(const std::string& path, const std::string& text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    // Written next to the file and renamed over it, so a load sees the old or the new file whole
+    void replace(const std::string& path, const std::string& text)
+    {
+        write(path + ".new", text);
+        std::filesystem::rename(path + ".new", path);
+    }
+
+    std::string generation(int value)
+    {
+        std::string number = std::to_string(value);
+        return "[a]\nfirst=" + number + "\nsecond=" + number + "\n";
+    }
+
+    void snapshots(const std::string& path)
+    {
+        write(path, "[a]\nx=1\n\n[a]\nx=2\n");
+
+        ConcurrentIniFile file(path);
+        check(file.read<int>("a", "x") == 1 && file.read<int>(IniSection("a", 1), "x") == 2, "loaded by the constructor");
+
+        std::shared_ptr<const IniFile> old = file.snapshot();
+
+        replace(path, "[a]\nx=3\n");
+        file.reload();
+
+        check(old->read<int>("a", "x") == 1 && old->sectionCount("a") == 2, "a held snapshot keeps its file");
+        check(file.read<int>("a", "x") == 3 && file.snapshot()->sectionCount("a") == 1, "reload publishes the new file");
+
+        replace(path, "[a]\nx=4\nx=5\n");
+        bool thrown = false;
+
+        try
+        {
+            file.reload();
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+
+        check(thrown && file.read<int>("a", "x") == 3, "a failed reload keeps the published file");
+
+        IniFile edited(path);
+        edited.writeKeyValue<int>(edited.writeSection("b"), "y", 6);
+        file.publish( std::move(edited) );
+
+        check(file.read<int>("b", "y") == 6 && !file.snapshot()->sectionExists("a"), "publish replaces the snapshot");
+    }
+
+    // Readers never see half of a reload: both keys of one snapshot come from the same file
+    void readersDuringReloads(const std::string& path)
+    {
+        write(path, generation(0));
+
+        ConcurrentIniFile file(path);
+        std::atomic<bool> done{false};
+        std::atomic<int> torn{0};
+        std::vector<std::thread> readers;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            readers.emplace_back([&](){
+                int last = 0;
+
+                while ( !done.load() )
+                {
+                    std::shared_ptr<const IniFile> current = file.snapshot();
+                    int first = current->read<int>("a", "first");
+
+                    if (first != current->read<int>("a", "second") || first < last)
+                    {
+                        ++torn;
+                    }
+
+                    last = first;
+                }
+            });
+        }
+
+        std::thread writer([&](){
+            for (int value = 1; value <= 200; ++value)
+            {
+                replace(path, generation(value));
+                file.reload();
+            }
+
+            done = true;
+        });
+
+        writer.join();
+
+        for (auto& reader : readers)
+        {
+            reader.join();
+        }
+
+        check(torn == 0, "every snapshot read whole and in order");
+        check(file.read<int>("a", "first") == 200, "last reload published");
+    }
+}
+
+int main()
+{
+    std::string path = (std::filesystem::temp_directory_path() / "IniFileConcurrentTest.ini").string();
+
+    snapshots(path);
+    readersDuringReloads(path);
+
+    std::filesystem::remove(path);
+
+    return failures == 0 ? 0 : 1;
+}
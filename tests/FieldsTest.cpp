@@ -0,0 +1,94 @@
+#include "IniFile.h"
+#include "Check.h"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    void write(const std::string& path, const std::string& text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    struct worker
+    {
+        int threads = -1;
+        std::string name;
+        bool verbose = false;
+        double ratio = -1;
+    };
+
+    void fields(const std::string& path)
+    {
+        write(path, "[worker]\nthreads=8\nname = fast\nverbose=true\n\n[worker]\nthreads=2\n\n[bad]\nthreads=many\n");
+
+        IniFile file(path);
+        file.load();
+
+        worker first;
+        file.readFields("worker", first, iniField("threads", &worker::threads, 4), iniField("name", &worker::name, "default"),
+                        iniField("verbose", &worker::verbose), iniField("ratio", &worker::ratio, 0.5));
+
+        check(first.threads == 8 && first.name == "fast" && first.verbose && first.ratio == 0.5, "values and a default");
+
+        worker second;
+        file.readFields(IniSection("worker", 1), second, iniField("threads", &worker::threads, 4),
+                        iniField("name", &worker::name, "default"), iniField("verbose", &worker::verbose, true));
+
+        check(second.threads == 2 && second.name == "default" && second.verbose && second.ratio == -1,
+              "duplicate section, unbound members kept");
+
+        worker missing;
+        file.readFields("nowhere", missing, iniField("threads", &worker::threads, 4), iniField("name", &worker::name, "none"));
+        check(missing.threads == 4 && missing.name == "none", "defaults for a missing section");
+
+        // Same values as read<T> of each key, also after a write
+        file.writeKeyValue<int>("worker", "threads", 16);
+        file.enableCache();
+
+        worker cached;
+        file.readFields("worker", cached, iniField("threads", &worker::threads), iniField("verbose", &worker::verbose));
+        check(cached.threads == file.read<int>("worker", "threads") && cached.threads == 16 && cached.verbose,
+              "written and cached values");
+
+        worker bad;
+        std::string message;
+
+        try
+        {
+            file.readFields("bad", bad, iniField("threads", &worker::threads));
+        }
+        catch (const std::runtime_error& error)
+        {
+            message = error.what();
+        }
+
+        std::string expected;
+
+        try
+        {
+            file.read<int>("bad", "threads");
+        }
+        catch (const std::runtime_error& error)
+        {
+            expected = error.what();
+        }
+
+        check( !message.empty() && message == expected, "parse error as read<T> reports it");
+    }
+}
+
+int main()
+{
+    std::string path = (std::filesystem::temp_directory_path() / "IniFileFieldsTest.ini").string();
+
+    fields(path);
+
+    std::filesystem::remove(path);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+#include "FrozenIniFile.h"
+#include "IniFile.h"
+#include "Check.h"
+
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    void write(const std::string& path, const std::string& text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    // Every section, key, value and line number in file order
+    template<typename File>
+    std::string describe(const File& file)
+    {
+        std::string out;
+
+        for (const IniSection& section : file.sections())
+        {
+            out += std::string( section.getName() ) + '#' + std::to_string( section.getIndex() ) + '@' +
+                   std::to_string( section.getLineNum() ) + '/' + std::to_string( file.sectionCount(section) ) + ':';
+
+            for (const std::string& key : file.keys(section))
+            {
+                out += key + '=' + file.template read<std::string>(section, key) + '@' +
+                       std::to_string( file.getKeyLineNum(section, key) ) + ',';
+            }
+
+            out += '\n';
+        }
+
+        return out;
+    }
+
+    template<typename File>
+    std::optional<std::string> readError(const File& file, const IniSection& section, std::string_view key)
+    {
+        try
+        {
+            file.template read<int>(section, key);
+        }
+        catch (const std::runtime_error& error)
+        {
+            return std::string( error.what() );
+        }
+
+        return std::nullopt;
+    }
+
+    void sameAsFile(const std::string& path)
+    {
+        write(path, "; head\n[server]\nport = 8080\nratio=0.25\nverbose=true\nname = main ; comment\n\n"
+                    "[client]\nport=1\n\n[server]\nport=9090\nbad=12x\n\n[empty]\n");
+
+        IniFile file(path);
+        file.load();
+        FrozenIniFile frozen = file.freeze();
+
+        check(describe(frozen) == describe(file), "same sections, keys, values and lines");
+        check(frozen.read<int>("server", "port") == 8080 && frozen.read<int>(IniSection("server", 1), "port") == 9090,
+              "duplicate sections by index");
+        check(frozen.read<double>("server", "ratio") == 0.25 && frozen.read<bool>("server", "verbose") &&
+              frozen.read<std::string>("server", "name") == "main", "typed reads");
+        check(frozen.read<int>("server", "missing", 7) == 7 && frozen.read<int>("nowhere", "port", 8) == 8 &&
+              frozen.read<int>(IniSection("server", 2), "port", 9) == 9, "defaults for what is missing");
+
+        check(frozen.sectionExists("empty") && !frozen.sectionExists("nowhere") && !frozen.sectionExists(IniSection("client", 1)),
+              "sectionExists");
+        check(frozen.keyExists("client", "port") && !frozen.keyExists("client", "ratio") && !frozen.keyExists("nowhere", "port"),
+              "keyExists");
+        check(frozen.sectionCount("server") == 2 && frozen.sectionRange("server").size() == 2 &&
+              frozen["server"].size() == 2 && frozen["nowhere"].empty(), "duplicate counts");
+        check(frozen.keys("empty").empty() && frozen.keys("nowhere").empty(), "no keys");
+
+        auto expected = readError(file, IniSection("server", 1), "bad");
+        check(expected && readError(frozen, IniSection("server", 1), "bad") == expected, "same parse error with its line");
+    }
+
+    // The snapshot holds what was written in memory and keeps nothing of the file or the IniFile
+    void snapshot(const std::string& path)
+    {
+        write(path, "[a]\nx=1\n");
+
+        std::optional<FrozenIniFile> frozen;
+
+        {
+            IniFile file(path);
+            file.load(LoadMode::Mapped);
+
+            file.writeKeyValue<int>("a", "x", 2);
+            file.writeKeyValue<int>(file.writeSection("b"), "y", 3);
+            frozen = file.freeze();
+
+            file.writeKeyValue<int>("a", "x", 4);
+            check(frozen->read<int>("a", "x") == 2, "later writes not seen");
+        }
+
+        write(path, "[c]\nz=5\n");
+
+        check(frozen->read<int>("a", "x") == 2 && frozen->read<int>("b", "y") == 3 && !frozen->sectionExists("c"),
+              "outlives the file and its text");
+
+        IniFile empty(path);
+        FrozenIniFile none = empty.freeze();
+        check(none.sections().empty() && none.read<int>("c", "z", 6) == 6, "freeze before load");
+    }
+
+    // Enough names for long probe runs in the open addressing tables
+    void manyNames(const std::string& path)
+    {
+        std::string text;
+
+        for (int i = 0; i < 3000; ++i)
+        {
+            text += "[s" + std::to_string(i % 1000) + "]\n";
+
+            for (int key = 0; key < i % 7; ++key)
+            {
+                text += "k" + std::to_string(key * 131 + i) + '=' + std::to_string(i) + '\n';
+            }
+        }
+
+        write(path, text);
+
+        IniFile file(path);
+        file.load();
+        FrozenIniFile frozen = file.freeze();
+
+        check(describe(frozen) == describe(file), "every name found");
+        check(frozen.sectionCount("s999") == 3 && frozen.read<int>(IniSection("s999", 2), "k" + std::to_string(131 + 2999)) == 2999,
+              "last duplicate");
+    }
+}
+
+int main()
+{
+    std::string path = (std::filesystem::temp_directory_path() / "IniFileFreezeTest.ini").string();
+
+    sameAsFile(path);
+    snapshot(path);
+    manyNames(path);
+
+    std::filesystem::remove(path);
+
+    return failures == 0 ? 0 : 1;
+}
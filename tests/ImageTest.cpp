@@ -0,0 +1,132 @@
+#include "FrozenIniFile.h"
+#include "IniFile.h"
+#include "Check.h"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    void write(const std::string& path, const std::string& text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    std::string readAll(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // Layout of the image parts the test changes, see FrozenIniFile.h
+    constexpr size_t headerBytes = 32;
+    constexpr size_t checksumOffset = 24;
+    constexpr size_t groupSlotCountOffset = headerBytes + 12;
+    constexpr size_t keySlotCountOffset = headerBytes + 16;
+    constexpr size_t sectionsOffset = headerBytes + 32;
+
+    std::uint32_t get(const std::string& image, size_t offset)
+    {
+        std::uint32_t value = 0;
+        std::memcpy(&value, image.data() + offset, sizeof(value));
+        return value;
+    }
+
+    void set(std::string& image, size_t offset, std::uint32_t value)
+    {
+        std::memcpy(&image[offset], &value, sizeof(value));
+    }
+
+    // Same checksum as FrozenIniFile, so only the validation can reject the image
+    void seal(std::string& image)
+    {
+        std::uint64_t hash = 14695981039346656037ull;
+
+        for (size_t pos = headerBytes; pos < image.size(); pos += sizeof(std::uint64_t))
+        {
+            std::uint64_t word = 0;
+            std::memcpy(&word, image.data() + pos, sizeof(word));
+
+            hash = (hash ^ word) * 1099511628211ull;
+            hash ^= hash >> 29;
+        }
+
+        std::memcpy(&image[checksumOffset], &hash, sizeof(hash));
+    }
+
+    bool rejected(const std::string& path, const std::string& image)
+    {
+        write(path, image);
+
+        try
+        {
+            FrozenIniFile::loadImage(path, LoadMode::Buffered);
+        }
+        catch (const std::runtime_error&)
+        {
+            return true;
+        }
+
+        return false;
+    }
+
+    void images(const std::string& iniPath, const std::string& path)
+    {
+        write(iniPath, "[s]\nk=v\n\n[s]\nk=w\n\n[t]\na=1\nb=2\n");
+
+        IniFile file(iniPath);
+        file.load();
+        file.freeze().saveImage(path);
+
+        std::string image = readAll(path);
+
+        {
+            FrozenIniFile frozen = FrozenIniFile::loadImage(path, LoadMode::Buffered);
+            check(frozen.read<std::string>(IniSection("s", 1), "k") == "w" && frozen.read<int>("t", "b") == 2,
+                  "valid image loads");
+        }
+
+        std::uint32_t groupSlots = get(image, groupSlotCountOffset);
+        std::uint32_t keySlots = get(image, keySlotCountOffset);
+
+        // Slots are two words each, moving one between the tables keeps the storage size
+        std::string changed = image;
+        set(changed, groupSlotCountOffset, groupSlots + 1);
+        set(changed, keySlotCountOffset, keySlots - 1);
+        seal(changed);
+        check(rejected(path, changed), "slot count not a power of two");
+
+        changed = image;
+        set(changed, sectionsOffset, 1u << 30);
+        seal(changed);
+        check(rejected(path, changed), "section name outside the text");
+
+        changed = image;
+        set(changed, sectionsOffset + 16, 1000);
+        seal(changed);
+        check(rejected(path, changed), "first key outside the keys");
+
+        changed = image;
+        seal(changed);
+        check( !rejected(path, changed), "resealed image still loads");
+    }
+}
+
+int main()
+{
+    std::string iniPath = (std::filesystem::temp_directory_path() / "IniFileImageTest.ini").string();
+    std::string path = (std::filesystem::temp_directory_path() / "IniFileImageTest.img").string();
+
+    images(iniPath, path);
+
+    std::filesystem::remove(iniPath);
+    std::filesystem::remove(path);
+
+    return failures == 0 ? 0 : 1;
+}
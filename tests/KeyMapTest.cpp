@@ -0,0 +1,166 @@
+#include "IniFile.h"
+#include "Check.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace
+{
+    void write(const std::string& path, const std::string& text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    std::string keys(size_t count, std::string_view value)
+    {
+        std::string text;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            text.append("key").append( std::to_string(i) ).append("=").append(value).append( std::to_string(i) ) += '\n';
+        }
+
+        return text;
+    }
+
+    // Sections around the linear limit and past several table sizes
+    void lookups(const std::string& path)
+    {
+        for (size_t count : {1, 8, 9, 16, 17, 100, 1000})
+        {
+            std::string name = std::to_string(count) + " keys: ";
+
+            write(path, "[s]\n" + keys(count, "v"));
+
+            IniFile file(path);
+            file.load();
+
+            bool found = true;
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                found = found && file.read<std::string>("s", "key" + std::to_string(i)) == "v" + std::to_string(i);
+            }
+
+            check(found, name + "every key found");
+            check(!file.keyExists("s", "key" + std::to_string(count)) && !file.keyExists("s", "key"), name + "missing keys");
+            check(file.keys("s").size() == count && file.keys("s").back() == "key" + std::to_string(count - 1),
+                  name + "file order kept");
+
+            // Written keys go through the same table, past the next table size
+            for (size_t i = count; i < count * 3; ++i)
+            {
+                file.writeKeyValue<size_t>("s", "key" + std::to_string(i), i);
+            }
+
+            found = true;
+
+            for (size_t i = 0; i < count * 3; ++i)
+            {
+                found = found && file.keyExists("s", "key" + std::to_string(i));
+            }
+
+            check(found && file.keys("s").size() == count * 3, name + "written keys found");
+            check(file.read<size_t>("s", "key" + std::to_string(count * 3 - 1)) == count * 3 - 1, name + "written value read");
+        }
+    }
+
+    void duplicates(const std::string& path)
+    {
+        write(path, "[s]\n" + keys(20, "v") + "key13=again\n");
+
+        bool thrown = false;
+
+        try
+        {
+            IniFile file(path);
+            file.load();
+        }
+        catch (const std::runtime_error& error)
+        {
+            thrown = std::string( error.what() ) == "duplicate key in line: 22";
+        }
+
+        check(thrown, "duplicate key in a large section rejected with its line");
+    }
+
+    // reload() moves reused keys onto the new text and rebuilds their table
+    void reload(const std::string& path)
+    {
+        write(path, "[a]\n" + keys(30, "a") + "\n[b]\n" + keys(30, "b"));
+
+        IniFile file(path);
+        file.load();
+
+        write(path, "; moved\n[a]\n" + keys(30, "a") + "\n[b]\n" + keys(31, "c"));
+        IniDiff diff = file.reload();
+
+        check(diff._changedSections.size() == 1 && diff._changedSections[0].getName() == "b", "reload: only b changed");
+        check(file.read<std::string>("a", "key29") == "a29" && file.getKeyLineNum("a", "key29") == 32, "reload: reused keys found");
+        check(file.read<std::string>("b", "key30") == "c30", "reload: new key found");
+        check(diff._changedKeys.size() == 31, "reload: every key of b reported");
+    }
+
+    // Every byte and the length of a name reach its hash, also for the word read twice at the end
+    void hashes()
+    {
+        std::set<size_t> seen;
+        size_t names = 0;
+
+        for (size_t size = 0; size <= 40; ++size)
+        {
+            std::string name(size, 'a');
+            seen.insert( parser::seededHash(name) );
+            ++names;
+
+            for (size_t pos = 0; pos < size; ++pos)
+            {
+                name[pos] = 'b';
+                seen.insert( parser::seededHash(name) );
+                name[pos] = 'a';
+                ++names;
+            }
+        }
+
+        check(seen.size() == names, "names one byte or one length apart hash apart");
+
+        // Numbered names spread over a half full table as they would in a section's key index
+        const size_t slots = 1 << 14;
+        std::vector<bool> used(slots, false);
+        size_t longest = 0;
+
+        for (size_t i = 0; i < slots / 2; ++i)
+        {
+            size_t run = 0;
+
+            for (size_t slot = parser::seededHash("key" + std::to_string(i)) & (slots - 1); used[slot]; slot = (slot + 1) & (slots - 1))
+            {
+                ++run;
+            }
+
+            used[(parser::seededHash("key" + std::to_string(i)) + run) & (slots - 1)] = true;
+            longest = std::max(longest, run);
+        }
+
+        check(longest < 64, "no long probe run for numbered names");
+    }
+}
+
+int main()
+{
+    std::string path = (std::filesystem::temp_directory_path() / "IniFileKeyMapTest.ini").string();
+
+    lookups(path);
+    duplicates(path);
+    reload(path);
+    hashes();
+
+    std::filesystem::remove(path);
+
+    return failures == 0 ? 0 : 1;
+}
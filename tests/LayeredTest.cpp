@@ -0,0 +1,109 @@
+#include "LayeredIniFile.h"
+#include "Check.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    void write(const std::string& path, const std::string& text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    void overrides(LoadMode mode, const std::vector<std::string>& paths)
+    {
+        std::string name = mode == LoadMode::Mapped ? "Mapped: " : "Buffered: ";
+
+        write(paths[0], "[server]\nhost=base\nport=80\nthreads=1\n\n[log]\nlevel=info\n\n[server]\nport=1\n");
+        write(paths[1], "[server]\nport=8080\n\n[site]\nname=local\n");
+        write(paths[2], "[server]\nthreads=4\nport=9090\nextra=yes\n");
+
+        LayeredIniFile config(paths, mode);
+
+        check(config.layerCount() == 3 && config.layer(1).read<int>("server", "port") == 8080, name + "layers kept in order");
+        check(config.read<std::string>("server", "host") == "base" && config.read<int>("server", "port") == 9090 &&
+              config.read<int>("server", "threads") == 4 && config.read<bool>("server", "extra"), name + "later layers override");
+
+        check(config.layerOf("server", "host") == 0 && config.layerOf("server", "port") == 2 && config.layerOf("site", "name") == 1 &&
+              config.layerOf("server", "missing") == LayeredIniFile::npos && config.layerOf("nowhere", "port") == LayeredIniFile::npos,
+              name + "winning layers");
+
+        check(config.read<int>("server", "missing", -1) == -1 && config.read<std::string>("log", "level") == "info", name + "defaults and base values");
+        check(config.sectionExists("site") && config.sectionExists("log") && !config.sectionExists("nowhere") &&
+              config.keyExists("server", "extra") && !config.keyExists("log", "extra"), name + "exists across layers");
+
+        check(config.keys("server") == std::vector<std::string>{"host", "port", "threads", "extra"} && config.keys("nowhere").empty(),
+              name + "merged keys in first appearance order");
+
+        write(paths[2], "");
+        config.reload(2);
+        check(config.read<int>("server", "port") == 8080 && config.layerOf("server", "port") == 1, name + "emptied layer falls back");
+
+        // Only the first section of a name takes part, the port=1 of the base stays hidden
+        write(paths[1], "[site]\nname=other\n");
+        IniDiff diff = config.reload(1);
+        check(diff._removedSections.size() == 1 && config.read<int>("server", "port") == 80 && config.layerOf("server", "port") == 0 &&
+              config.read<std::string>("site", "name") == "other", name + "removed section falls back to the base");
+
+        write(paths[0], "[log]\nlevel=debug\n");
+        config.reload(0);
+        check( !config.sectionExists("server") && config.keys("server").empty() && config.read<std::string>("log", "level") == "debug",
+              name + "section gone from every layer");
+
+        write(paths[2], "[server]\nport=1234\n\n[log]\nlevel=trace\nfile=out\n");
+        diff = config.reload(2);
+        check(diff._addedSections.size() == 2 && config.read<int>("server", "port") == 1234 && config.layerOf("log", "level") == 2 &&
+              config.keys("log") == std::vector<std::string>{"level", "file"}, name + "added sections override again");
+
+        // A reload with the same text changes nothing
+        diff = config.reload(2);
+        check(diff._changedSections.empty() && diff._addedSections.empty() && config.read<int>("server", "port") == 1234,
+              name + "unchanged reload");
+    }
+
+    void cached(const std::vector<std::string>& paths)
+    {
+        write(paths[0], "[a]\nx=1\ny=2\n");
+        write(paths[1], "[a]\nx=10\n");
+        write(paths[2], "");
+
+        LayeredIniFile config(paths);
+        config.enableCache();
+
+        check(config.read<int>("a", "x") == 10 && config.read<int>("a", "y") == 2, "cached reads");
+
+        write(paths[1], "[a]\nx=20\n");
+        config.reload(1);
+        check(config.read<int>("a", "x") == 20, "cache sees a reload");
+
+        write(paths[2], "[a]\ny=30\n");
+        config.reload(2);
+        check(config.read<int>("a", "y") == 30 && config.read<int>("a", "x") == 20, "cache sees a new override");
+    }
+}
+
+int main()
+{
+    auto directory = std::filesystem::temp_directory_path();
+    std::vector<std::string> paths;
+
+    for (const char* name : {"IniFileLayeredTest.base.ini", "IniFileLayeredTest.site.ini", "IniFileLayeredTest.user.ini"})
+    {
+        paths.push_back( (directory / name).string() );
+    }
+
+    overrides(LoadMode::Buffered, paths);
+    overrides(LoadMode::Mapped, paths);
+    cached(paths);
+
+    for (const std::string& path : paths)
+    {
+        std::filesystem::remove(path);
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+#include "IniFile.h"
+#include "Check.h"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    void write(const std::string& path, const std::string& text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    // About 3 MiB, so a threaded load splits it into several chunks. Names repeat across chunks
+    // and one section is long enough to swallow a chunk bound
+    std::string bigText()
+    {
+        std::string text = "; generated\n\n";
+
+        for (int i = 0; i < 60000; ++i)
+        {
+            text += "[section" + std::to_string(i % 700) + "]\n";
+            text += "id=" + std::to_string(i) + "\nname = worker ; comment\nvalue=" + std::string(i % 13, 'x') + "y\n\n";
+
+            if (i == 30000)
+            {
+                text += "[long]\n";
+
+                for (int key = 0; key < 40000; ++key)
+                {
+                    text += "k" + std::to_string(key) + "=v\n";
+                }
+            }
+        }
+
+        return text;
+    }
+
+    std::string describe(const IniFile& file)
+    {
+        std::string out;
+
+        for (const IniSection& section : file.sections())
+        {
+            out += std::string( section.getName() ) + '#' + std::to_string( section.getIndex() ) + '@' +
+                   std::to_string( section.getLineNum() ) + ':';
+
+            for (const std::string& key : file.keys(section))
+            {
+                out += key + '=' + file.read<std::string>(section, key) + '@' +
+                       std::to_string( file.getKeyLineNum(section, key) ) + ',';
+            }
+
+            out += '\n';
+        }
+
+        return out;
+    }
+
+    std::string loadError(const std::string& path, LoadMode mode, unsigned threadCount)
+    {
+        IniFile file(path);
+
+        try
+        {
+            file.load(mode, threadCount);
+        }
+        catch (const std::runtime_error& error)
+        {
+            return error.what();
+        }
+
+        return "";
+    }
+
+    void sameAsSequential(const std::string& path)
+    {
+        write(path, bigText());
+
+        IniFile sequential(path);
+        sequential.load();
+        std::string expected = describe(sequential);
+
+        for (LoadMode mode : {LoadMode::Buffered, LoadMode::Mapped})
+        {
+            std::string name = mode == LoadMode::Mapped ? "Mapped" : "Buffered";
+
+            for (unsigned threadCount : {2u, 3u, 8u, 0u})
+            {
+                IniFile threaded(path);
+                threaded.load(mode, threadCount);
+
+                check(describe(threaded) == expected, name + " load on " + std::to_string(threadCount) + " threads");
+                check(threaded.sectionCount("section5") == sequential.sectionCount("section5"), name + " section index");
+            }
+        }
+    }
+
+    // Errors in several chunks, the threaded load reports the first one in the file
+    void firstError(const std::string& path)
+    {
+        std::string text = bigText();
+
+        size_t late = text.find("[section9]\n", text.size() * 3 / 4);
+        text.insert(late + 11, "id=again\nid=twice\n");
+
+        size_t early = text.find("[section3]\n", text.size() / 2);
+        text.insert(early + 11, "=no key\n");
+
+        write(path, text);
+
+        std::string expected = loadError(path, LoadMode::Buffered, 1);
+        check(expected.find("empty key or value") != std::string::npos, "sequential load fails at the first error");
+
+        for (unsigned threadCount : {2u, 4u, 8u})
+        {
+            check(loadError(path, LoadMode::Buffered, threadCount) == expected,
+                  "same error on " + std::to_string(threadCount) + " threads");
+        }
+    }
+}
+
+int main()
+{
+    std::string path = (std::filesystem::temp_directory_path() / "IniFileLoadTest.ini").string();
+
+    sameAsSequential(path);
+    firstError(path);
+
+    std::filesystem::remove(path);
+
+    return failures == 0 ? 0 : 1;
+}
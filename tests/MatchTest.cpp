@@ -0,0 +1,125 @@
+#include "IniFile.h"
+#include "IniBuilder.h"
+#include "Check.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace
+{
+    void write(const std::string& path, const std::string& text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    // Names with the line number of each match, in the order the view returns them
+    std::string sections(const IniFile::SectionMatchView& view)
+    {
+        std::string out;
+
+        for (IniFile::SectionRef section : view)
+        {
+            out += std::string( section.getName() ) + '@' + std::to_string( section.getLineNum() ) + ' ';
+        }
+
+        return out;
+    }
+
+    std::string keys(const IniFile::KeyMatchView& view)
+    {
+        std::string out;
+
+        for (IniFile::KeyMatch match : view)
+        {
+            out += std::string( match._section.getName() ) + '.' + std::string(match._key._key) + ' ';
+        }
+
+        return out;
+    }
+
+    void patterns(const std::string& path)
+    {
+        write(path, "[upstream.b]\nlimit_rate=1\n\n[down]\nlimit=2\n\n[upstream.a]\nlimit_rate=3\nrate=4\n\n"
+                    "[upstream.b]\nx=5\n\n[upstreamer]\ny=6\n\n[up]\nz=7\n");
+
+        IniFile file(path);
+        file.load();
+
+        check(sections( file.sectionsMatching("upstream.*") ) == "upstream.a@7 upstream.b@1 upstream.b@11 ",
+              "prefix: sorted by name, duplicates in file order");
+        check(sections( file.sectionsMatching("upstream") ).empty(), "no glob matches the whole name only");
+        check(sections( file.sectionsMatching("up*") ) == "up@17 upstream.a@7 upstream.b@1 upstream.b@11 upstreamer@14 ",
+              "a star matches an empty run");
+        check(sections( file.sectionsMatching("upstream.?") ) == "upstream.a@7 upstream.b@1 upstream.b@11 ", "question mark");
+        check(sections( file.sectionsMatching("*stream*") ) == "upstream.a@7 upstream.b@1 upstream.b@11 upstreamer@14 ",
+              "leading star scans every name");
+        check(sections( file.sectionsMatching("u?stream?a") ) == "upstream.a@7 ", "question marks inside the name");
+        check(sections( file.sectionsMatching("*") ).size() == sections( file.sectionsMatching("**") ).size(), "stars collapse");
+        check(sections( file.sectionsMatching("") ).empty(), "empty pattern matches no named section");
+        check(sections( file.sectionsMatching("zzz*") ).empty() && sections( file.sectionsMatching("a*") ).empty(),
+              "prefixes outside the names");
+
+        check(keys( file.keysMatching("limit_*") ) == "upstream.b.limit_rate upstream.a.limit_rate ", "keys by prefix");
+        check(keys( file.keysMatching("*rate") ) == "upstream.b.limit_rate upstream.a.limit_rate upstream.a.rate ",
+              "keys by suffix");
+        check(keys( file.keysMatching("") ).empty(), "empty key pattern");
+
+        // The views keep their own copy of the pattern
+        std::string prefix = "upstream";
+        std::string found;
+
+        for (IniFile::SectionRef section : file.sectionsMatching(prefix + ".?"))
+        {
+            found += std::string( section.getName() ) + ' ';
+        }
+
+        check(found == "upstream.a upstream.b upstream.b ", "pattern from a temporary string");
+
+        IniFile::KeyMatchView view = file.keysMatching(std::string("limit") + "*");
+        check(keys(view) == "down.limit upstream.b.limit_rate upstream.a.limit_rate ", "view stored after its pattern died");
+    }
+
+    // Every change drops the index, the next query sees the new names
+    void invalidation(const std::string& path)
+    {
+        write(path, "[a1]\nk=1\n\n[b1]\nk=2\n");
+
+        IniFile file(path);
+        file.load();
+
+        check(sections( file.sectionsMatching("a*") ) == "a1@1 ", "first query");
+
+        file.writeSection("a2");
+        check(sections( file.sectionsMatching("a*") ) == "a1@1 a2@0 ", "index dropped by writeSection");
+
+        file.writeKeyValue<int>("b1", "key_new", 3);
+        check(keys( file.keysMatching("key_*") ) == "b1.key_new ", "key index dropped by writeKeyValue");
+
+        write(path, "[a3]\nk=1\n");
+        file.load();
+        check(sections( file.sectionsMatching("a*") ) == "a3@1 ", "index dropped by load");
+        check(keys( file.keysMatching("key_*") ).empty(), "key index dropped by load");
+
+        IniBuilder builder(file);
+        builder.section("a4").add("key_built", 1);
+        check(sections( file.sectionsMatching("a*") ) == "a3@1 ", "builder changes nothing before commit");
+
+        builder.commit();
+        check(sections( file.sectionsMatching("a*") ) == "a3@1 a4@0 ", "index dropped by builder commit");
+        check(keys( file.keysMatching("key_*") ) == "a4.key_built ", "key index dropped by builder commit");
+    }
+}
+
+int main()
+{
+    std::string path = (std::filesystem::temp_directory_path() / "IniFileMatchTest.ini").string();
+
+    patterns(path);
+    invalidation(path);
+
+    std::filesystem::remove(path);
+
+    return failures == 0 ? 0 : 1;
+}
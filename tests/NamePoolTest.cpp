@@ -0,0 +1,133 @@
+#include "IniFile.h"
+#include "Check.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    void write(const std::string& path, const std::string& text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    std::string contents(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    void interning()
+    {
+        IniNamePool pool;
+
+        const std::string* first = pool.intern("name");
+        std::string copy = "name";
+
+        check(pool.intern(copy) == first && *first == "name", "equal names share one string");
+        check(pool.intern("other") != first && pool.size() == 2, "distinct names stored apart");
+
+        // Stored names never move while the pool grows
+        for (int i = 0; i < 10000; ++i)
+        {
+            pool.intern("n" + std::to_string(i));
+        }
+
+        check(pool.intern("name") == first && *first == "name" && pool.size() == 10002, "addresses kept");
+    }
+
+    void threads()
+    {
+        IniNamePool pool;
+        const int threadCount = 8;
+        const int names = 2000;
+
+        std::vector<std::vector<const std::string*>> seen(threadCount);
+        std::vector<std::thread> workers;
+
+        for (int t = 0; t < threadCount; ++t)
+        {
+            workers.emplace_back([&, t](){
+                for (int i = 0; i < names; ++i)
+                {
+                    seen[t].push_back( pool.intern("n" + std::to_string((i * 7 + t) % names)) );
+                }
+            });
+        }
+
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+
+        bool same = true;
+
+        for (int t = 0; t < threadCount; ++t)
+        {
+            for (int i = 0; i < names; ++i)
+            {
+                const std::string* name = seen[t][i];
+                same = same && *name == "n" + std::to_string((i * 7 + t) % names) && pool.intern(*name) == name;
+            }
+        }
+
+        check(same && pool.size() == names, "every thread gets the one string of a name");
+    }
+
+    void sharedByFiles(const std::string& path)
+    {
+        std::string otherPath = path + ".other";
+        write(path, "[server]\nport=1\nhost=a\n\n[client]\nport=2\n");
+        write(otherPath, "[server]\nport=3\nname=b\n");
+
+        auto pool = std::make_shared<IniNamePool>();
+
+        IniFile first(path);
+        IniFile second(otherPath);
+        first.setNamePool(pool);
+        second.setNamePool(pool);
+        first.load(LoadMode::Mapped);
+        second.load(LoadMode::Mapped);
+
+        check(first.sections()[0].getName().data() == second.sections()[0].getName().data(), "one name for both files");
+        check(pool->size() == 5, "server, client, port, host and name stored once");
+
+        // Values are copied, so the mapped text may change under the files
+        write(path, "[xxxxxx]\nxxxx=9\nxxxx=9\n\n[xxxxxx]\nxxxx=9\n");
+
+        check(first.read<int>("server", "port") == 1 && first.read<std::string>("server", "host") == "a" &&
+              first.read<int>("client", "port") == 2 && second.read<int>("server", "port") == 3, "values kept from the load");
+
+        write(path, "[server]\nport=4\n");
+        IniDiff diff = first.reload();
+
+        check(first.read<int>("server", "port") == 4 && !first.sectionExists("client") &&
+              diff._removedSections.size() == 1 && pool->size() == 5, "reload interns in the same pool");
+
+        // Without the file text saveChanges() saves the whole file
+        first.writeKeyValue<int>("server", "port", 5);
+        first.saveChanges();
+        check(contents(path) == "[server]\nport = 5\n\n", "saveChanges() falls back to save()");
+
+        std::filesystem::remove(otherPath);
+    }
+}
+
+int main()
+{
+    std::string path = (std::filesystem::temp_directory_path() / "IniFileNamePoolTest.ini").string();
+
+    interning();
+    threads();
+    sharedByFiles(path);
+
+    std::filesystem::remove(path);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+#include "IniFile.h"
+#include "IniBuilder.h"
+#include "Check.h"
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+
+namespace
+{
+    template<typename T>
+    std::string format(T value)
+    {
+        char buffer[parser::formatLength<T>];
+        return std::string( buffer, parser::formatNumber(value, buffer) );
+    }
+
+    template<typename T>
+    bool parsed(std::string_view text, T expected)
+    {
+        T value{};
+        return parser::parseNumber(text, value) == nullptr && (value == expected || (std::isnan(value) && std::isnan(expected)));
+    }
+
+    void nonFinite()
+    {
+        constexpr double inf = std::numeric_limits<double>::infinity();
+        constexpr float nan = std::numeric_limits<float>::quiet_NaN();
+
+        check(format(inf) == "inf" && format(-inf) == "-inf" && format(nan) == "nan", "non-finite text");
+        check(parsed("inf", inf) && parsed("-inf", -inf) && parsed("nan", nan) && parsed("-nan", -nan), "non-finite parsed");
+
+        int number = 0;
+        double real = 0;
+
+        check(parser::parseNumber("inf", number) != nullptr && parser::parseNumber("nan", number) != nullptr, "integral rejects inf and nan");
+        check(parser::parseNumber("infinity", real) != nullptr && parser::parseNumber("in", real) != nullptr, "other words rejected");
+    }
+
+    // Every written value is read back as the same T, after a save and a load too
+    void roundTrip(const std::string& path)
+    {
+        IniFile file(path);
+        IniSection section = file.writeSection("s");
+
+        file.writeKeyValue<char>(section, "letter", 'z');
+        file.writeKeyValue<char>(section, "digit", '7');
+        file.writeKeyValue<double>(section, "inf", std::numeric_limits<double>::infinity());
+        file.writeKeyValue<double>(section, "negative inf", -std::numeric_limits<double>::infinity());
+        file.writeKeyValue<float>(section, "nan", std::numeric_limits<float>::quiet_NaN());
+
+        IniBuilder builder(file);
+        builder.section("b").add("letter", 'q').add("inf", std::numeric_limits<float>::infinity());
+        builder.commit();
+
+        file.save();
+
+        IniFile loaded(path);
+        loaded.load();
+
+        for (const IniFile* item : {&file, &loaded})
+        {
+            std::string name = item == &file ? "written: " : "loaded: ";
+
+            check(item->read<char>("s", "letter") == 'z' && item->read<std::string>("s", "letter") == "z", name + "char as one character");
+            check(item->read<char>("s", "digit") == '7', name + "digit char");
+            check(item->read<double>("s", "inf") == std::numeric_limits<double>::infinity(), name + "inf");
+            check(item->read<double>("s", "negative inf") == -std::numeric_limits<double>::infinity(), name + "-inf");
+            check(std::isnan( item->read<float>("s", "nan") ), name + "nan");
+            check(item->read<char>("b", "letter") == 'q', name + "builder char");
+            check(item->read<float>("b", "inf") == std::numeric_limits<float>::infinity(), name + "builder inf");
+        }
+    }
+}
+
+int main()
+{
+    std::string path = (std::filesystem::temp_directory_path() / "IniFileNumberTest.ini").string();
+
+    nonFinite();
+    roundTrip(path);
+
+    std::filesystem::remove(path);
+
+    return failures == 0 ? 0 : 1;
+}
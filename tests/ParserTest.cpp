@@ -0,0 +1,142 @@
+#include "IniParser.h"
+#include "Check.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    void write(const std::string& path, const std::string& text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    // Every callback as one line of text, errors are skipped so the parse goes on
+    class recorder : public IniHandler
+    {
+    public:
+        std::string _events;
+        size_t _stopAfter = SIZE_MAX;
+        size_t _keys = 0;
+
+        bool onSection(std::string_view name, size_t lineNum) override
+        {
+            _events += "S " + std::string(name) + '@' + std::to_string(lineNum) + '\n';
+            return true;
+        }
+
+        bool onKeyValue(std::string_view key, std::string_view value, size_t lineNum) override
+        {
+            _events += "K " + std::string(key) + '=' + std::string(value) + '@' + std::to_string(lineNum) + '\n';
+            return ++_keys < _stopAfter;
+        }
+
+        bool onComment(std::string_view text, size_t lineNum) override
+        {
+            _events += "C " + std::string(text) + '@' + std::to_string(lineNum) + '\n';
+            return true;
+        }
+
+        bool onError(const std::string& message, size_t lineNum) override
+        {
+            _events += "E " + message + '@' + std::to_string(lineNum) + '\n';
+            return true;
+        }
+    };
+
+    const std::string sample = "; head\nkey=before\n[s]\nk = v ; note\n\n[t]\r\nlong=" + std::string(300, 'x') +
+                               "\n=novalue\n  [ spaced ]  \nlast = end";
+
+    void events(const std::string& path)
+    {
+        recorder expected;
+        check(IniParser::parse(sample, expected), "parse of a text returns true");
+
+        check(expected._events == "C  head@1\nE key and value without section@2\nS s@3\nK k=v@4\nS t@6\n"
+                                  "K long=" + std::string(300, 'x') + "@7\nE empty key or value@8\nS  spaced @9\n"
+                                  "K last=end@10\n", "callbacks in file order with line numbers");
+
+        write(path, sample);
+
+        // Lines cross chunk bounds, one is longer than several chunks
+        for (size_t chunkSize : {1, 2, 3, 7, 64, 65536})
+        {
+            recorder streamed;
+            check(IniParser(path, chunkSize).parse(streamed) && streamed._events == expected._events,
+                  "same callbacks with chunks of " + std::to_string(chunkSize));
+        }
+    }
+
+    void stopEarly(const std::string& path)
+    {
+        write(path, "[s]\na=1\nb=2\nc=3\n");
+
+        recorder handler;
+        handler._stopAfter = 2;
+
+        check( !IniParser(path, 4).parse(handler), "parse returns false when a handler stops it");
+        check(handler._events == "S s@1\nK a=1@2\nK b=2@3\n", "nothing reported after the stop");
+    }
+
+    void errors(const std::string& path)
+    {
+        write(path, "[s]\nk=1\n=2\n");
+
+        IniHandler plain;
+        std::string message;
+
+        try
+        {
+            IniParser(path).parse(plain);
+        }
+        catch (const std::runtime_error& error)
+        {
+            message = error.what();
+        }
+
+        check(message == "empty key or value in line: 3", "the default handler throws like load()");
+
+        bool thrown = false;
+
+        try
+        {
+            IniParser(path, 0);
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+
+        check(thrown, "chunk size zero rejected");
+
+        thrown = false;
+
+        try
+        {
+            IniParser(path + ".missing").parse(plain);
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+
+        check(thrown, "missing file");
+    }
+}
+
+int main()
+{
+    std::string path = (std::filesystem::temp_directory_path() / "IniFileParserTest.ini").string();
+
+    events(path);
+    stopEarly(path);
+    errors(path);
+
+    std::filesystem::remove(path);
+
+    return failures == 0 ? 0 : 1;
+}
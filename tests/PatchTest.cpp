@@ -0,0 +1,181 @@
+#include "IniFile.h"
+#include "Check.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace
+{
+    void write(const std::string& path, const std::string& text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    std::string contents(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    // Every saveChanges() starts from the file the previous one left, with nothing loaded again
+    void sequence(LoadMode mode, const std::string& path)
+    {
+        std::string name = mode == LoadMode::Mapped ? "Mapped: " : "Buffered: ";
+
+        write(path, "; head\n[a]\nx=1\ny=2\n\n[b]\nz=3\n");
+
+        IniFile file(path);
+        file.load(mode);
+
+        file.writeKeyValue<int>("a", "x", 12345);
+        file.saveChanges();
+        check(contents(path) == "; head\n[a]\nx=12345\ny=2\n\n[b]\nz=3\n", name + "longer value");
+
+        file.writeKeyValue<int>("b", "z", 4);
+        file.saveChanges();
+        check(contents(path) == "; head\n[a]\nx=12345\ny=2\n\n[b]\nz=4\n", name + "in place after a longer value");
+
+        file.writeKeyValue<int>("a", "x", 9);
+        file.saveChanges();
+        check(contents(path) == "; head\n[a]\nx=9    \ny=2\n\n[b]\nz=4\n", name + "shorter value padded");
+
+        file.writeKeyValue<int>("a", "w", 5);
+        file.saveChanges();
+        check(contents(path) == "; head\n[a]\nx=9    \ny=2\n\nw = 5\n[b]\nz=4\n", name + "new key");
+
+        IniSection section = file.writeSection("c");
+        file.writeKeyValue<int>(section, "k", 1);
+        file.writeKeyValue<int>("b", "q", 2);
+        file.saveChanges();
+        check(contents(path) == "; head\n[a]\nx=9    \ny=2\n\nw = 5\n[b]\nz=4\nq = 2\n\n[c]\nk = 1\n", name + "new section");
+
+        file.writeKeyValue<int>(section, "k", 22);
+        file.saveChanges();
+        check(contents(path) == "; head\n[a]\nx=9    \ny=2\n\nw = 5\n[b]\nz=4\nq = 2\n\n[c]\nk = 22\n", name + "longer value in a new section");
+
+        // A mapped file is loaded again after a tail rewrite, so k is then a loaded value padded in place
+        file.writeKeyValue<int>(section, "k", 3);
+        file.saveChanges();
+        check(contents(path) == "; head\n[a]\nx=9    \ny=2\n\nw = 5\n[b]\nz=4\nq = 2\n\n[c]\nk = "
+                                + std::string(mode == LoadMode::Mapped ? "3 \n" : "3\n"), name + "file shrinks");
+
+        IniFile loaded(path);
+        loaded.load();
+
+        check(loaded.read<int>("a", "x") == 9 && loaded.read<int>("a", "w") == 5 && loaded.read<int>("b", "q") == 2
+              && loaded.read<int>("c", "k") == 3, name + "saved file loads");
+
+        write(path, "[a]\nx=1\n");
+        file.writeKeyValue<int>("a", "x", 2);
+
+        bool thrown = false;
+
+        try
+        {
+            file.saveChanges();
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+
+        check(thrown, name + "changed file rejected");
+    }
+
+    void afterSave(const std::string& path)
+    {
+        write(path, "[a]\nx=1\ny=2\n");
+
+        IniFile file(path);
+        file.load();
+
+        file.writeKeyValue<int>("a", "x", 5);
+        file.save();
+
+        file.writeKeyValue<int>("a", "y", 7);
+        file.saveChanges();
+
+        IniFile loaded(path);
+        loaded.load();
+
+        check(loaded.read<int>("a", "x") == 5 && loaded.read<int>("a", "y") == 7, "saveChanges() after save()");
+    }
+
+    // Bytes changed behind the file's back with its stamp kept, to see what a save writes again
+    void overwrite(const std::string& path, size_t offset, const std::string& text)
+    {
+        auto time = std::filesystem::last_write_time(path);
+
+        {
+            std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+            file.seekp( static_cast<std::streamoff>(offset) );
+            file << text;
+        }
+
+        std::filesystem::last_write_time(path, time);
+    }
+
+    // A saved edit is written once, later saves only write what changed since
+    void appliedOnce(const std::string& path)
+    {
+        write(path, "[a]\nx=1\ny=2\n\n[b]\nz=3\n");
+
+        IniFile file(path);
+        file.load();
+
+        file.writeKeyValue<int>("a", "x", 7);
+        file.writeKeyValue<int>("a", "w", 8);
+        file.saveChanges();
+        check(contents(path) == "[a]\nx=7\ny=2\n\nw = 8\n[b]\nz=3\n", "first save");
+
+        overwrite(path, 6, "6");
+        overwrite(path, 17, "9");
+
+        file.writeKeyValue<int>("b", "z", 4);
+        file.saveChanges();
+        check(contents(path) == "[a]\nx=6\ny=2\n\nw = 9\n[b]\nz=4\n", "saved edits not written again");
+
+        file.writeKeyValue<int>("a", "x", 5);
+        file.saveChanges();
+        check(contents(path) == "[a]\nx=5\ny=2\n\nw = 9\n[b]\nz=4\n", "an edit saved before is written when it changes");
+
+        file.writeKeyValue<int>("a", "x", 12);
+        file.writeKeyValue<int>("b", "z", 0);
+        file.saveChanges();
+        check(contents(path) == "[a]\nx=12\ny=2\n\nw = 8\n[b]\nz=0\n", "a longer value rewrites the tail from memory");
+    }
+
+    void emptyFile(const std::string& path)
+    {
+        write(path, "");
+
+        IniFile file(path);
+        file.load();
+
+        file.writeKeyValue<int>(file.writeSection("s"), "k", 1);
+        file.saveChanges();
+        check(contents(path) == "[s]\nk = 1\n", "first section of an empty file");
+
+        file.writeKeyValue<int>(file.writeSection("t"), "v", 2);
+        file.saveChanges();
+        check(contents(path) == "[s]\nk = 1\n\n[t]\nv = 2\n", "second section of an empty file");
+    }
+}
+
+int main()
+{
+    std::string path = (std::filesystem::temp_directory_path() / "IniFilePatchTest.ini").string();
+
+    sequence(LoadMode::Buffered, path);
+    sequence(LoadMode::Mapped, path);
+    afterSave(path);
+    appliedOnce(path);
+    emptyFile(path);
+
+    std::filesystem::remove(path);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,84 @@
+#include "IniRecord.h"
+#include "IniFile.h"
+#include "Check.h"
+
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    inline constexpr IniKey<std::string> host("host");
+    inline constexpr IniKey<int> port("port");
+    inline constexpr IniKey<double> ratio("ratio");
+    inline constexpr IniKey<bool> verbose("verbose");
+    inline constexpr IniKey<std::optional<int>> backlog("backlog");
+
+    // Two keys of one name and type are still two keys
+    inline constexpr IniKey<int> otherPort("port");
+
+    static_assert(port._hash == parser::hashName("port") && port._hash != ratio._hash, "hashed at compile time");
+
+    void write(const std::string& path, const std::string& text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    template<typename F>
+    std::string error(F&& body)
+    {
+        try
+        {
+            body();
+        }
+        catch (const std::runtime_error& exception)
+        {
+            return exception.what();
+        }
+
+        return "";
+    }
+
+    void records(const std::string& path)
+    {
+        write(path, "[server]\nhost = example.org\nport=8080\nratio=0.5\nverbose=true\n\n"
+                    "[server]\nhost=backup\nport=9090\nratio=2\nverbose=false\nbacklog=64\n\n"
+                    "[broken]\nhost=x\nport=80a\nratio=1\nverbose=true\n\n[partial]\nhost=y\n");
+
+        IniFile file(path);
+        file.load();
+        FrozenIniFile frozen = file.freeze();
+
+        IniRecord<host, port, ratio, verbose, backlog> first(frozen, "server");
+        check(first.get<host>() == "example.org" && first.get<port>() == 8080 && first.get<ratio>() == 0.5 &&
+              first.get<verbose>() && !first.get<backlog>(), "typed values, an optional key missing");
+
+        IniRecord<host, port, ratio, verbose, backlog> second(frozen, IniSection("server", 1));
+        check(second.get<host>() == "backup" && second.get<port>() == frozen.read<int>(IniSection("server", 1), "port") &&
+              !second.get<verbose>() && second.get<backlog>() == 64, "duplicate section by index, an optional key present");
+
+        IniRecord<port, otherPort> twice(frozen, "server");
+        check(twice.get<port>() == 8080 && twice.get<otherPort>() == 8080, "keys told apart by object");
+
+        check(error([&](){ IniRecord<host, port> record(frozen, "partial"); }) == "key not found: port", "missing key");
+        check(error([&](){ IniRecord<host> record(frozen, "nowhere"); }) == "section not found: nowhere", "missing section");
+
+        std::string expected = error([&](){ frozen.read<int>("broken", "port"); });
+        check( !expected.empty() && error([&](){ IniRecord<host, port> record(frozen, "broken"); }) == expected,
+              "bad value reported with its line as read<T> does");
+    }
+}
+
+int main()
+{
+    std::string path = (std::filesystem::temp_directory_path() / "IniFileRecordTest.ini").string();
+
+    records(path);
+
+    std::filesystem::remove(path);
+
+    return failures == 0 ? 0 : 1;
+}
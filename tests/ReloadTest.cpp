@@ -0,0 +1,68 @@
+#include "IniFile.h"
+#include "Check.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace
+{
+    // Truncates and writes the same inode, the way editors without atomic save do
+    void rewrite(const std::string& path, const std::string& text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    void inPlaceRewrite(LoadMode mode, const std::string& path)
+    {
+        std::string name = mode == LoadMode::Mapped ? "Mapped: " : "Buffered: ";
+
+        rewrite(path, "[a]\nx=1\ny=2\n\n[b]\nz=3\n");
+
+        IniFile file(path);
+        file.load(mode);
+
+        rewrite(path, "[a]\nx = 7\ny=2\n\n[b]\nz=3\n");
+        IniDiff diff = file.reload();
+
+        check(diff._changedSections.size() == 1 && diff._changedSections[0].getName() == "a", name + "section a changed");
+        check(diff._addedSections.empty() && diff._removedSections.empty(), name + "nothing added or removed");
+        check(file.read<int>("a", "x") == 7, name + "new value read after reload");
+        check(file.read<int>("b", "z") == 3, name + "unchanged section kept");
+
+        bool xChanged = false;
+
+        for (const auto& [section, key] : diff._changedKeys)
+        {
+            xChanged = xChanged || (section.getName() == "a" && key == "x");
+        }
+
+        check(xChanged, name + "key x reported");
+
+        rewrite(path, "[b]\nz=4\n");
+        diff = file.reload();
+
+        check(diff._removedSections.size() == 1 && diff._removedSections[0].getName() == "a", name + "section a removed");
+        check(diff._changedSections.size() == 1 && file.read<int>("b", "z") == 4, name + "section b changed");
+
+        // Unchanged text is reused, an empty diff stays empty
+        rewrite(path, "[b]\nz=4\n");
+        diff = file.reload();
+
+        check(diff._changedSections.empty() && diff._changedKeys.empty(), name + "rewrite with the same text");
+    }
+}
+
+int main()
+{
+    std::string path = (std::filesystem::temp_directory_path() / "IniFileReloadTest.ini").string();
+
+    inPlaceRewrite(LoadMode::Buffered, path);
+    inPlaceRewrite(LoadMode::Mapped, path);
+
+    std::filesystem::remove(path);
+
+    return failures == 0 ? 0 : 1;
+}
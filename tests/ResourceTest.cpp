@@ -0,0 +1,138 @@
+#include "IniFile.h"
+#include "Check.h"
+
+#include <filesystem>
+#include <fstream>
+#include <memory_resource>
+#include <string>
+
+namespace
+{
+    void write(const std::string& path, const std::string& text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    class countingResource : public std::pmr::memory_resource
+    {
+    public:
+        size_t _allocations = 0;
+        size_t _live = 0;
+        size_t _largest = 0;
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override
+        {
+            ++_allocations;
+            ++_live;
+            _largest = bytes > _largest ? bytes : _largest;
+
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* memory, size_t bytes, size_t alignment) override
+        {
+            --_live;
+            std::pmr::new_delete_resource()->deallocate(memory, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+
+    std::string text()
+    {
+        std::string out;
+
+        for (int i = 0; i < 200; ++i)
+        {
+            out += "[section" + std::to_string(i % 50) + "]\n";
+
+            for (int key = 0; key < 12; ++key)
+            {
+                out += "key" + std::to_string(key) + '=' + std::to_string(i * key) + '\n';
+            }
+
+            out += '\n';
+        }
+
+        return out;
+    }
+
+    // Nothing of a file may come from the default resource, which counts strays here
+    void everythingFromResource(const std::string& path, countingResource& strays)
+    {
+        countingResource mine;
+        std::string content = text();
+        write(path, content);
+
+        {
+            IniFile file(path, &mine);
+            file.load();
+
+            check(mine._largest >= content.size(), "file buffer from the resource");
+
+            size_t before = mine._allocations;
+            file.enableCache();
+            check(file.read<int>(IniSection("section7", 1), "key11") == 57 * 11 &&
+                  file.read<int>(IniSection("section7", 1), "key11") == 57 * 11, "cached read");
+            check(mine._allocations > before, "cache tables from the resource");
+
+            before = mine._allocations;
+            check(file.sectionsMatching("section1*").size() == 44, "section query");
+            check(file.keysMatching("key1?").size() == 400, "key query");
+            check(mine._allocations > before, "name indexes from the resource");
+
+            file.writeKeyValue<int>("section3", "added", 1);
+            IniSection written = file.writeSection("new");
+            file.writeKeyValue<double>(written, "value", 2.5);
+
+            before = mine._allocations;
+            IniFile copy(file);
+            check(mine._allocations > before, "copy allocates from the resource of its source");
+
+            copy.writeKeyValue<int>("section3", "copied", 2);
+            copy.writeKeyValue<int>(IniSection("new", 0), "more", 3);
+            check(copy.read<int>(IniSection("section7", 1), "key11") == 57 * 11 && copy.read<double>("new", "value") == 2.5,
+                  "copy reads");
+
+            countingResource other;
+            {
+                IniFile assigned(path, &other);
+                assigned.load();
+
+                assigned = copy;
+                check(assigned.read<int>("section3", "copied") == 2, "assigned file reads");
+
+                assigned.writeKeyValue<int>("section4", "assigned", 4);
+                assigned.reload();
+            }
+
+            check(other._live == 0, "assignment released the old resource");
+
+            file.reload();
+            check(file.read<int>("section3", "added", 0) == 0, "reload drops unsaved keys");
+        }
+
+        check(strays._allocations == 0, "no allocation from the default resource");
+        check(mine._live == 0, "everything given back to the resource");
+    }
+}
+
+int main()
+{
+    std::string path = (std::filesystem::temp_directory_path() / "IniFileResourceTest.ini").string();
+
+    countingResource strays;
+    std::pmr::memory_resource* previous = std::pmr::set_default_resource(&strays);
+
+    everythingFromResource(path, strays);
+
+    std::pmr::set_default_resource(previous);
+    std::filesystem::remove(path);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+#include "IniFile.h"
+#include "Check.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    void write(const std::string& path, const std::string& text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    std::string contents(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    std::string describe(const IniFile& file)
+    {
+        std::string out;
+
+        for (const IniSection& section : file.sections())
+        {
+            out += std::string( section.getName() ) + '#' + std::to_string( section.getIndex() ) + ':';
+
+            for (const std::string& key : file.keys(section))
+            {
+                out += key + '=' + file.read<std::string>(section, key) + ',';
+            }
+
+            out += '\n';
+        }
+
+        return out;
+    }
+
+    // Sections in file order with their keys in file and then insertion order, comments and spacing dropped
+    void output(LoadMode mode, const std::string& path)
+    {
+        std::string name = mode == LoadMode::Mapped ? "Mapped: " : "Buffered: ";
+
+        write(path, "; head\n[b]\n  y = 2 ; note\nx=1\n\n[a]\nz=3\n\n[b]\nw=4\n");
+
+        IniFile file(path);
+        file.load(mode);
+
+        file.writeKeyValue<int>("b", "y", 20);
+        file.writeKeyValue<int>("b", "added", 5);
+        file.writeKeyValue<bool>(IniSection("b", 1), "flag", true);
+        file.writeKeyValue<int>(file.writeSection("c"), "v", 6);
+        file.save();
+
+        std::string expected = "[b]\ny = 20\nx = 1\nadded = 5\n\n[a]\nz = 3\n\n[b]\nw = 4\nflag = true\n\n[c]\nv = 6\n\n";
+        check(contents(path) == expected, name + "saved text");
+
+        IniFile loaded(path);
+        loaded.load(mode);
+        check(describe(loaded) == describe(file), name + "saved file loads the same");
+
+        // The whole text is built before the file is truncated, also when it is mapped
+        loaded.save();
+        check(contents(path) == expected, name + "save of a saved file");
+    }
+
+    void edges(const std::string& path)
+    {
+        write(path, "");
+
+        IniFile empty(path);
+        empty.load();
+        empty.save();
+        check(contents(path).empty(), "empty file");
+
+        // A pool keeps no view into the file, the values are copies
+        write(path, "[s]\nk=" + std::string(5000, 'v') + "\n");
+
+        IniFile pooled(path);
+        pooled.setNamePool( std::make_shared<IniNamePool>() );
+        pooled.load();
+        pooled.save();
+        check(contents(path) == "[s]\nk = " + std::string(5000, 'v') + "\n\n", "long value with a name pool");
+
+        IniFile unwritable( (std::filesystem::temp_directory_path() / "IniFileSaveTest.missing" / "file.ini").string() );
+        unwritable.writeKeyValue<int>(unwritable.writeSection("s"), "k", 1);
+
+        bool thrown = false;
+
+        try
+        {
+            unwritable.save();
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+
+        check(thrown, "no directory to save into");
+    }
+}
+
+int main()
+{
+    std::string path = (std::filesystem::temp_directory_path() / "IniFileSaveTest.ini").string();
+
+    output(LoadMode::Buffered, path);
+    output(LoadMode::Mapped, path);
+    edges(path);
+
+    std::filesystem::remove(path);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,105 @@
+#include "IniScanner.h"
+#include "Check.h"
+
+#include <random>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    // Marks found with string_view searches, what both scan paths must return
+    parser::lineMarks reference(std::string_view text)
+    {
+        size_t newline = text.find('\n');
+        std::string_view line = text.substr(0, newline);
+
+        return {newline == std::string_view::npos ? text.size() : newline, line.find('['), line.rfind(']'),
+                line.find('='), line.find(';')};
+    }
+
+    bool same(const parser::lineMarks& left, const parser::lineMarks& right)
+    {
+        return left._length == right._length && left._leftBracket == right._leftBracket &&
+               left._rightBracket == right._rightBracket && left._equal == right._equal && left._comment == right._comment;
+    }
+
+    std::string printable(std::string_view text)
+    {
+        std::string out;
+
+        for (char c : text)
+        {
+            out += c == '\n' ? std::string("\\n") : c == '\r' ? std::string("\\r") : std::string(1, c);
+        }
+
+        return out;
+    }
+
+    void compare(std::string_view text)
+    {
+        parser::lineMarks expected = reference(text);
+
+        check(same(parser::scanLine(text), expected), "scanLine: \"" + printable(text) + '"');
+        check(same(parser::scanLineScalar(text), expected), "scanLineScalar: \"" + printable(text) + '"');
+    }
+
+    // Every mark and every pair of marks on each position around the 16 and 32 byte blocks,
+    // in whole blocks and in the last partial one
+    void boundaries()
+    {
+        const std::string marks = "\n[]=;\r";
+        const size_t sizes[] = {0, 1, 15, 16, 17, 31, 32, 33, 47, 48, 49, 63, 64, 65, 80, 97};
+
+        for (size_t size : sizes)
+        {
+            for (size_t first = 0; first < size; ++first)
+            {
+                for (char one : marks)
+                {
+                    std::string text(size, 'a');
+                    text[first] = one;
+                    compare(text);
+
+                    for (size_t second = first + 1; second < size; ++second)
+                    {
+                        for (char two : marks)
+                        {
+                            text[second] = two;
+                            compare(text);
+                            text[second] = 'a';
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void randomLines()
+    {
+        const std::string alphabet = "ab [];=\r\n";
+        std::mt19937 generator(7);
+
+        for (int round = 0; round < 20000; ++round)
+        {
+            std::string text(generator() % 200, 'a');
+
+            for (char& c : text)
+            {
+                // Mostly plain bytes so that lines cross several blocks
+                c = generator() % 8 == 0 ? alphabet[generator() % alphabet.size()] : 'a';
+            }
+
+            // Also start the view inside a block, the loads are unaligned
+            size_t skip = text.empty() ? 0 : generator() % (text.size() < 40 ? text.size() : 40);
+            compare( std::string_view(text).substr(skip) );
+        }
+    }
+}
+
+int main()
+{
+    boundaries();
+    randomLines();
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+#include "IniFile.h"
+#include "ConcurrentIniFile.h"
+#include "Check.h"
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+    void write(const std::string& path, const std::string& text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    static_assert( !std::is_constructible_v<IniSection, std::string>, "a temporary std::string would dangle" );
+    static_assert( std::is_constructible_v<IniSection, const std::string&> );
+
+    // Returned handles keep their names after the caller's text and the file's old text are gone
+    void handles(const std::string& path)
+    {
+        IniFile file(path);
+        file.load();
+
+        std::vector<IniSection> all = file.sections();
+        std::vector<IniSection> range;
+        std::vector<IniSection> fromViews;
+
+        {
+            std::string name = "b";
+            range = file.sectionRange(name);
+        }
+
+        for (IniFile::SectionRef section : file.sectionsView())
+        {
+            fromViews.push_back(section);
+        }
+
+        write(path, "[a]\nx=2\n");
+        IniDiff diff = file.reload();
+        file.writeSection("c");
+
+        check(all.size() == 3 && all[0].getName() == "a" && all[2].getName() == "b" && all[2].getIndex() == 1,
+              "sections() outlive a reload");
+        check(range.size() == 2 && range[1].getName() == "b" && range[1].getLineNum() == 7, "sectionRange() outlives its argument");
+        check(fromViews.size() == 3 && fromViews[1].getName() == "b", "handles of views outlive a reload");
+        check(diff._removedSections.size() == 2 && diff._removedSections[0].getName() == "b", "removed sections");
+    }
+
+    // Copies share the names, a shared pool keeps them after the file is gone
+    void owners(const std::string& path)
+    {
+        auto pool = std::make_shared<IniNamePool>();
+        std::vector<IniSection> copied;
+        std::vector<IniSection> pooled;
+
+        {
+            IniFile file(path);
+            file.load();
+
+            IniFile copy(file);
+            copied = copy.sections();
+
+            IniFile tenant(path);
+            tenant.setNamePool(pool);
+            tenant.load();
+            pooled = tenant.sections();
+
+            check(copied.size() == 3 && copied[1].getName() == "b", "handles of a copy");
+        }
+
+        check(pooled.size() == 3 && pooled[2].getName() == "b", "handles of a shared pool outlive the file");
+        check(pool->size() == 4, "pool holds section and key names once");
+    }
+
+    void reads(const std::string& path)
+    {
+        ConcurrentIniFile config(path);
+        std::string name = "b";
+
+        check(config.read<int>("a", "x") == 1, "read by literal");
+        check(config.read<int>(name, "y") == 2, "read by std::string");
+        check(config.read<int>(std::string_view(name), "y") == 2, "read by string_view");
+        check(config.read<int>(IniSection(name, 1), "y") == 3, "read by IniSection");
+        check(config.read<int>("missing", "x", 5) == 5, "default value");
+    }
+}
+
+int main()
+{
+    std::string path = (std::filesystem::temp_directory_path() / "IniFileSectionTest.ini").string();
+
+    write(path, "[a]\nx=1\n\n[b]\ny=2\n\n[b]\ny=3\n");
+    reads(path);
+    handles(path);
+
+    write(path, "[a]\nx=1\n\n[b]\ny=2\n\n[b]\ny=3\n");
+    owners(path);
+
+    std::filesystem::remove(path);
+
+    return failures == 0 ? 0 : 1;
+}
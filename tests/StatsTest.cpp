@@ -0,0 +1,84 @@
+#include "IniStats.h"
+#include "Check.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    void counts()
+    {
+        IniCounters counters;
+
+        {
+            // The counters copy the name, the caller's text may go away
+            std::string name = "server";
+            counters.onLookup(name, "port", true, true);
+            counters.onLookup(name, "host", true, false);
+        }
+
+        counters.onLookup("client", "port", false, false);
+
+        auto sections = counters.sections();
+        check(sections.size() == 2, "one entry per name");
+        check(sections["server"]._lookups == 2 && sections["server"]._misses == 1, "server counted");
+        check(sections["client"]._lookups == 1 && sections["client"]._misses == 1, "client counted");
+        check(counters.snapshot()._lookups == 3 && counters.snapshot()._defaultHits == 2, "totals");
+    }
+
+    // More names than the limit from many threads, every lookup is counted once
+    void bounded()
+    {
+        IniCounters counters;
+        const size_t names = 3 * IniCounters::sectionLimit;
+        const int threadCount = 8;
+
+        std::vector<std::thread> threads;
+
+        for (int t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back([&](){
+                for (size_t i = 0; i < names; ++i)
+                {
+                    counters.onLookup("section" + std::to_string(i), "key", true, i % 2 == 0);
+                }
+            });
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        auto sections = counters.sections();
+        IniCounters::sectionValues other = counters.otherSections();
+
+        size_t lookups = other._lookups;
+        size_t misses = other._misses;
+        bool even = true;
+
+        for (const auto& pair : sections)
+        {
+            lookups += pair.second._lookups;
+            misses += pair.second._misses;
+            even = even && pair.second._lookups == threadCount;
+        }
+
+        check(sections.size() <= IniCounters::sectionLimit && sections.size() > IniCounters::sectionLimit / 2,
+              "names past the limit get no entry");
+        check(other._lookups % threadCount == 0 && other._lookups > 0, "each name kept out counted by every thread");
+        check(even, "each name counted once per thread");
+        check(lookups == names * threadCount, "no lookup lost");
+        check(misses == names / 2 * threadCount, "no miss lost");
+    }
+}
+
+int main()
+{
+    counts();
+    bounded();
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+#include "IniFile.h"
+#include "Check.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <string>
+
+namespace
+{
+    size_t allocations = 0;
+
+    void write(const std::string& path, const std::string& text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    std::string text()
+    {
+        std::string out = "; head\n";
+
+        for (int i = 0; i < 40; ++i)
+        {
+            out += "[s" + std::to_string(i % 9) + "]\n";
+
+            for (int key = 0; key < i % 5; ++key)
+            {
+                out += "k" + std::to_string(key) + " = " + std::to_string(i * 10 + key) + '\n';
+            }
+
+            out += '\n';
+        }
+
+        // Past the linear limit of the key table
+        out += "[wide]\n";
+
+        for (int key = 0; key < 100; ++key)
+        {
+            out += "w" + std::to_string(key) + '=' + std::to_string(key) + '\n';
+        }
+
+        return out;
+    }
+
+    void sameAsVectors(const std::string& path)
+    {
+        IniFile file(path);
+        file.load();
+
+        std::vector<IniSection> sections = file.sections();
+        size_t pos = 0;
+        bool same = file.sectionsView().size() == sections.size() && !file.sectionsView().empty();
+
+        for (IniFile::SectionRef section : file.sectionsView())
+        {
+            same = same && pos < sections.size() && section.getName() == sections[pos].getName() &&
+                   section.getIndex() == sections[pos].getIndex() && section.getLineNum() == sections[pos].getLineNum();
+
+            std::vector<std::string> keys = file.keys(sections[pos]);
+            size_t key = 0;
+
+            for (IniFile::KeyValue pair : section.keys())
+            {
+                same = same && key < keys.size() && pair._key == keys[key] &&
+                       pair._value == file.read<std::string>(sections[pos], keys[key]) &&
+                       pair._lineNum == file.getKeyLineNum(sections[pos], keys[key]) && section.value(pair._key) == pair._value;
+                ++key;
+            }
+
+            same = same && key == keys.size() && file.keysView(sections[pos]).size() == keys.size();
+            ++pos;
+        }
+
+        check(same && pos == sections.size(), "sections and keys as the vectors list them");
+
+        std::vector<IniSection> range = file.sectionRange("s3");
+        pos = 0;
+
+        for (IniFile::SectionRef section : file.sectionRangeView("s3"))
+        {
+            same = same && pos < range.size() && section.getLineNum() == range[pos].getLineNum() &&
+                   section.getIndex() == pos;
+            ++pos;
+        }
+
+        check(same && pos == range.size() && pos == 5, "duplicates of one name");
+
+        check(file.sectionRangeView("nowhere").empty() && file.keysView("nowhere").empty() &&
+              file.keysView(IniSection("s0", 9)).empty(), "empty views for missing sections");
+        check(file.keysView("wide").size() == 100 && (*file.sectionsView().begin()).value("missing").empty(), "sizes and missing keys");
+
+        IniSection handle = *++file.sectionRangeView("s4").begin();
+        check(file.read<int>(handle, "k2", -1) == 132, "a reference turns into a handle for reads");
+    }
+
+    // Iterating only walks the stored sections and keys
+    void noAllocation(const std::string& path)
+    {
+        IniFile file(path);
+        file.load();
+
+        size_t sum = 0;
+        size_t before = allocations;
+
+        for (IniFile::SectionRef section : file.sectionsView())
+        {
+            for (IniFile::KeyValue pair : section.keys())
+            {
+                sum += pair._value.size();
+            }
+        }
+
+        for (IniFile::SectionRef section : file.sectionRangeView("s1"))
+        {
+            sum += section.value("k2").size() + file.keysView(section.getName()).size();
+        }
+
+        // Taken before the message of check() is built
+        size_t made = allocations - before;
+        check(made == 0 && sum > 0, "views allocate nothing");
+    }
+}
+
+// Counted to see that the views allocate nothing
+void* operator new(size_t size)
+{
+    ++allocations;
+
+    if (void* memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    ::operator delete(memory);
+}
+
+int main()
+{
+    std::string path = (std::filesystem::temp_directory_path() / "IniFileViewTest.ini").string();
+    write(path, text());
+
+    sameAsVectors(path);
+    noAllocation(path);
+
+    std::filesystem::remove(path);
+
+    return failures == 0 ? 0 : 1;
+}